@@ -0,0 +1,212 @@
+#include "allocation_tracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib> // std::malloc, std::aligned_alloc, std::free
+#include <cstring> // std::memcpy
+#include <new>
+
+// Replacements for every form of the global operator new and delete. Each block gets a header
+// holding its size, so deallocations are counted in bytes even when the unsized delete is called.
+namespace {
+
+std::atomic<uint64_t> global_allocations{0};
+std::atomic<uint64_t> global_deallocations{0};
+std::atomic<uint64_t> global_bytes_allocated{0};
+std::atomic<uint64_t> global_bytes_deallocated{0};
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_live_bytes{0};
+
+// Trivial types only: thread_local objects with constructors could allocate on first use
+thread_local uint64_t thread_allocations = 0;
+thread_local uint64_t thread_deallocations = 0;
+thread_local uint64_t thread_bytes_allocated = 0;
+thread_local uint64_t thread_bytes_deallocated = 0;
+
+constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+// The header is a whole alignment unit, so the returned pointer keeps the requested alignment
+size_t HeaderSize(size_t alignment) {
+  return std::max(kDefaultAlignment, alignment);
+}
+
+void* Allocate(size_t size, size_t alignment) {
+  size_t header_size = HeaderSize(alignment);
+  void* block = nullptr;
+  if (alignment <= kDefaultAlignment) {
+    block = std::malloc(header_size + size);
+  } else {
+    // aligned_alloc needs a size that is a multiple of the alignment
+    size_t block_size = (header_size + size + alignment - 1) / alignment * alignment;
+    block = std::aligned_alloc(alignment, block_size);
+  }
+  if (block == nullptr) {
+    return nullptr;
+  }
+  char* user_pointer = static_cast<char*>(block) + header_size;
+  std::memcpy(user_pointer - sizeof(size_t), &size, sizeof(size_t));
+
+  global_allocations.fetch_add(1, std::memory_order_relaxed);
+  global_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+  ++thread_allocations;
+  thread_bytes_allocated += size;
+  int64_t live = live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                 static_cast<int64_t>(size);
+  int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  return user_pointer;
+}
+
+// Calls the new handler until the allocation succeeds, like the default operator new
+void* AllocateOrThrow(size_t size, size_t alignment) {
+  while (true) {
+    void* pointer = Allocate(size, alignment);
+    if (pointer != nullptr) {
+      return pointer;
+    }
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* AllocateNoThrow(size_t size, size_t alignment) noexcept {
+  try {
+    return AllocateOrThrow(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void Deallocate(void* pointer, size_t alignment) noexcept {
+  if (pointer == nullptr) {
+    return;
+  }
+  char* user_pointer = static_cast<char*>(pointer);
+  size_t size = 0;
+  std::memcpy(&size, user_pointer - sizeof(size_t), sizeof(size_t));
+  global_deallocations.fetch_add(1, std::memory_order_relaxed);
+  global_bytes_deallocated.fetch_add(size, std::memory_order_relaxed);
+  ++thread_deallocations;
+  thread_bytes_deallocated += size;
+  live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+  std::free(user_pointer - HeaderSize(alignment));
+}
+
+}  // namespace
+
+namespace allocation_tracker {
+
+AllocationCounts GlobalCounts() {
+  AllocationCounts counts;
+  counts.allocations = global_allocations.load(std::memory_order_relaxed);
+  counts.deallocations = global_deallocations.load(std::memory_order_relaxed);
+  counts.bytes_allocated = global_bytes_allocated.load(std::memory_order_relaxed);
+  counts.bytes_deallocated = global_bytes_deallocated.load(std::memory_order_relaxed);
+  return counts;
+}
+
+AllocationCounts ThreadCounts() {
+  AllocationCounts counts;
+  counts.allocations = thread_allocations;
+  counts.deallocations = thread_deallocations;
+  counts.bytes_allocated = thread_bytes_allocated;
+  counts.bytes_deallocated = thread_bytes_deallocated;
+  return counts;
+}
+
+uint64_t PeakLiveBytes() {
+  return static_cast<uint64_t>(std::max<int64_t>(0, peak_live_bytes.load()));
+}
+
+void ResetPeakLiveBytes() {
+  peak_live_bytes = live_bytes.load();
+}
+
+}  // namespace allocation_tracker
+
+void* operator new(size_t size) {
+  return AllocateOrThrow(size, kDefaultAlignment);
+}
+
+void* operator new[](size_t size) {
+  return AllocateOrThrow(size, kDefaultAlignment);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, kDefaultAlignment);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, kDefaultAlignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete[](void* pointer) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  Deallocate(pointer, kDefaultAlignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment,
+                       const std::nothrow_t&) noexcept {
+  Deallocate(pointer, static_cast<size_t>(alignment));
+}
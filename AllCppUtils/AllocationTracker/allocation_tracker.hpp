@@ -0,0 +1,78 @@
+#ifndef ALLOCATION_TRACKER_HPP
+#define ALLOCATION_TRACKER_HPP
+
+#include <cstdint>
+#include <ostream>
+
+// Counts heap allocations made through the global operator new / delete, which
+// allocation_tracker.cpp replaces: link it into the test binary to enable tracking.
+//
+//   g++ -std=c++17 -O2 test.cpp allocation_tracker.cpp
+//
+//   allocation_tracker::Scope scope;
+//   SplitString(line, ',', table);
+//   assert(scope.ThreadCounts().allocations == 0);
+//
+// Totals are kept for the whole process and for each thread. ThreadCounts() ignores allocations
+// from other threads, such as a test runner's workers.
+namespace allocation_tracker {
+
+struct AllocationCounts {
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t bytes_deallocated = 0;
+
+  // Bytes allocated and not yet freed (negative if memory allocated earlier was freed)
+  int64_t LiveBytes() const {
+    return static_cast<int64_t>(bytes_allocated) - static_cast<int64_t>(bytes_deallocated);
+  }
+
+  AllocationCounts operator-(const AllocationCounts& start) const {
+    AllocationCounts delta;
+    delta.allocations = allocations - start.allocations;
+    delta.deallocations = deallocations - start.deallocations;
+    delta.bytes_allocated = bytes_allocated - start.bytes_allocated;
+    delta.bytes_deallocated = bytes_deallocated - start.bytes_deallocated;
+    return delta;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const AllocationCounts& counts) {
+  os << counts.allocations << " allocations (" << counts.bytes_allocated << " bytes), "
+     << counts.deallocations << " deallocations (" << counts.bytes_deallocated << " bytes)";
+  return os;
+}
+
+// Defined in allocation_tracker.cpp
+AllocationCounts GlobalCounts();
+AllocationCounts ThreadCounts();
+// Highest number of live bytes over all threads since the start (or the last reset)
+uint64_t PeakLiveBytes();
+void ResetPeakLiveBytes();
+
+// Allocations made since construction (or the last Reset) of the scope
+class Scope {
+ public:
+  Scope() { Reset(); }
+
+  // All threads
+  AllocationCounts Counts() const { return GlobalCounts() - global_start_; }
+  // The thread the scope was created on, when called from that thread
+  AllocationCounts ThreadCounts() const {
+    return allocation_tracker::ThreadCounts() - thread_start_;
+  }
+
+  void Reset() {
+    global_start_ = GlobalCounts();
+    thread_start_ = allocation_tracker::ThreadCounts();
+  }
+
+ private:
+  AllocationCounts global_start_;
+  AllocationCounts thread_start_;
+};
+
+}  // namespace allocation_tracker
+
+#endif  // ALLOCATION_TRACKER_HPP
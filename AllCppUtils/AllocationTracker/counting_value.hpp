@@ -0,0 +1,158 @@
+#ifndef COUNTING_VALUE_HPP
+#define COUNTING_VALUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <utility> // std::move
+
+// Snapshot of the special member calls made on a CountingValue type
+struct CopyMoveCounts {
+  uint64_t default_constructions = 0;
+  uint64_t value_constructions = 0;
+  uint64_t copy_constructions = 0;
+  uint64_t move_constructions = 0;
+  uint64_t copy_assignments = 0;
+  uint64_t move_assignments = 0;
+  uint64_t destructions = 0;
+
+  uint64_t Constructions() const {
+    return default_constructions + value_constructions + copy_constructions + move_constructions;
+  }
+  uint64_t Copies() const { return copy_constructions + copy_assignments; }
+  uint64_t Moves() const { return move_constructions + move_assignments; }
+  // Objects constructed and not yet destroyed (negative if more were destroyed)
+  int64_t Live() const {
+    return static_cast<int64_t>(Constructions()) - static_cast<int64_t>(destructions);
+  }
+
+  CopyMoveCounts operator-(const CopyMoveCounts& start) const {
+    CopyMoveCounts delta;
+    delta.default_constructions = default_constructions - start.default_constructions;
+    delta.value_constructions = value_constructions - start.value_constructions;
+    delta.copy_constructions = copy_constructions - start.copy_constructions;
+    delta.move_constructions = move_constructions - start.move_constructions;
+    delta.copy_assignments = copy_assignments - start.copy_assignments;
+    delta.move_assignments = move_assignments - start.move_assignments;
+    delta.destructions = destructions - start.destructions;
+    return delta;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const CopyMoveCounts& counts) {
+  os << "constructed " << counts.Constructions() << " (default " << counts.default_constructions
+     << ", value " << counts.value_constructions << ", copy " << counts.copy_constructions
+     << ", move " << counts.move_constructions << "), assigned copy " << counts.copy_assignments
+     << " move " << counts.move_assignments << ", destroyed " << counts.destructions;
+  return os;
+}
+
+// Wraps a T and counts every construction, copy, move and destruction, with atomic counters so
+// it can be used from several threads. Replaces the printing Thing / Point test classes in
+// automated checks, e.g. that a code path makes no copies:
+//
+//   CountingValue<int>::Scope scope;
+//   VectorAppend(destination, std::move(source));
+//   assert(scope.Counts().Copies() == 0);
+//
+// Counters are per type: give unrelated tests a Tag type to keep their counts apart.
+template <typename T, typename Tag = void>
+class CountingValue {
+ public:
+  CountingValue() : value_() { Increment(counters_.default_constructions); }
+  CountingValue(const T& value) : value_(value) { Increment(counters_.value_constructions); }
+  CountingValue(T&& value) : value_(std::move(value)) {
+    Increment(counters_.value_constructions);
+  }
+  CountingValue(const CountingValue& other) : value_(other.value_) {
+    Increment(counters_.copy_constructions);
+  }
+  CountingValue(CountingValue&& other) noexcept : value_(std::move(other.value_)) {
+    Increment(counters_.move_constructions);
+  }
+
+  CountingValue& operator=(const CountingValue& other) {
+    value_ = other.value_;
+    Increment(counters_.copy_assignments);
+    return *this;
+  }
+
+  CountingValue& operator=(CountingValue&& other) noexcept {
+    value_ = std::move(other.value_);
+    Increment(counters_.move_assignments);
+    return *this;
+  }
+
+  ~CountingValue() { Increment(counters_.destructions); }
+
+  T& Value() { return value_; }
+  const T& Value() const { return value_; }
+
+  friend bool operator==(const CountingValue& left, const CountingValue& right) {
+    return left.value_ == right.value_;
+  }
+  friend bool operator!=(const CountingValue& left, const CountingValue& right) {
+    return !(left.value_ == right.value_);
+  }
+  friend bool operator<(const CountingValue& left, const CountingValue& right) {
+    return left.value_ < right.value_;
+  }
+  friend std::ostream& operator<<(std::ostream& os, const CountingValue& counting_value) {
+    return os << counting_value.value_;
+  }
+
+  // Totals since the start of the program (or the last ResetCounts)
+  static CopyMoveCounts Counts() {
+    CopyMoveCounts counts;
+    counts.default_constructions = counters_.default_constructions.load();
+    counts.value_constructions = counters_.value_constructions.load();
+    counts.copy_constructions = counters_.copy_constructions.load();
+    counts.move_constructions = counters_.move_constructions.load();
+    counts.copy_assignments = counters_.copy_assignments.load();
+    counts.move_assignments = counters_.move_assignments.load();
+    counts.destructions = counters_.destructions.load();
+    return counts;
+  }
+
+  static void ResetCounts() {
+    counters_.default_constructions = 0;
+    counters_.value_constructions = 0;
+    counters_.copy_constructions = 0;
+    counters_.move_constructions = 0;
+    counters_.copy_assignments = 0;
+    counters_.move_assignments = 0;
+    counters_.destructions = 0;
+  }
+
+  // Counts made since construction (or the last Reset) of the scope
+  class Scope {
+   public:
+    Scope() : start_(CountingValue::Counts()) {}
+    CopyMoveCounts Counts() const { return CountingValue::Counts() - start_; }
+    void Reset() { start_ = CountingValue::Counts(); }
+
+   private:
+    CopyMoveCounts start_;
+  };
+
+ private:
+  struct Counters {
+    std::atomic<uint64_t> default_constructions{0};
+    std::atomic<uint64_t> value_constructions{0};
+    std::atomic<uint64_t> copy_constructions{0};
+    std::atomic<uint64_t> move_constructions{0};
+    std::atomic<uint64_t> copy_assignments{0};
+    std::atomic<uint64_t> move_assignments{0};
+    std::atomic<uint64_t> destructions{0};
+  };
+
+  static inline Counters counters_;
+
+  static void Increment(std::atomic<uint64_t>& counter) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  T value_;
+};
+
+#endif  // COUNTING_VALUE_HPP
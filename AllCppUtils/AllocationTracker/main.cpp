@@ -0,0 +1,35 @@
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocation_tracker.hpp"
+#include "counting_value.hpp"
+
+// Build with the tracker linked in:
+//   g++ -std=c++17 -O2 main.cpp allocation_tracker.cpp
+int main() {
+  // Growing a vector moves the old elements, since the move constructor is noexcept
+  using Thing = CountingValue<int>;
+  std::vector<Thing> things;
+  for (int i = 0; i < 5; ++i) {
+    things.push_back(Thing(i));
+  }
+  std::cout << "push_back x5: " << Thing::Counts() << std::endl;
+
+  Thing::Scope scope;
+  std::vector<Thing> copied = things;
+  std::vector<Thing> moved = std::move(things);
+  std::cout << "copy then move the vector: " << scope.Counts() << std::endl;
+  std::cout << std::endl;
+
+  allocation_tracker::Scope allocations;
+  std::string small("fits in the SSO");
+  std::string large("does not fit in the small string buffer");
+  std::cout << "two strings: " << allocations.ThreadCounts() << std::endl;
+  large.clear();
+  large += "reuses the buffer after clear()";
+  std::cout << "after reuse: " << allocations.ThreadCounts() << std::endl;
+  std::cout << "peak live heap: " << allocation_tracker::PeakLiveBytes() << " bytes" << std::endl;
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../HumanReadableNumber/human_readable_number.hpp"
+#include "../LineReader/line_reader.hpp"
+#include "../ReadableNumberFormatting/format_number.hpp"
+#include "../SortPairs/sort_pairs.hpp"
+#include "../StringSplitJoin/string_join.hpp"
+#include "../StringSplitJoin/string_split.hpp"
+#include "../StringSplitJoin/string_table.hpp"
+#include "../VectorConcat/vector_concat.hpp"
+#include "allocation_tracker.hpp"
+#include "counting_value.hpp"
+
+// Allocation and copy budgets for the hot paths of the string, number and vector utilities.
+// Build with the tracker linked in:
+//   g++ -std=c++17 -O2 -pthread test.cpp allocation_tracker.cpp
+// Counts are per thread, and taken after a warm-up call where buffers are reused, so they
+// measure the steady state of a loop.
+
+int num_failures = 0;
+
+void CheckBudget(const char* name, uint64_t actual, uint64_t budget, const char* what) {
+  bool ok = actual <= budget;
+  num_failures += !ok;
+  std::cout << (ok ? "OK     " : "FAILED ") << name << ": " << actual << " " << what
+            << " (budget " << budget << ")" << std::endl;
+}
+
+void CheckAllocations(const char* name, const allocation_tracker::Scope& scope, uint64_t budget) {
+  CheckBudget(name, scope.ThreadCounts().allocations, budget, "allocations");
+}
+
+const std::vector<std::string> kLines = {
+    "id,name,score,comment", "1,ada,97,", "2,grace,100,a somewhat longer comment field",
+    "3,,88,x", "4,linus,73,another comment that does not fit in a small string buffer"};
+
+void TestStringUtils() {
+  StringTable table;
+  std::vector<std::string_view> fields;
+  std::string output;
+  auto run_lines = [&]() {
+    for (const std::string& line : kLines) {
+      SplitString(line, ',', table, true);
+      SplitFields(line, ',', fields, true);
+      output.clear();
+      JoinInto(output, table, " | ");
+      JoinInto(output, fields, ';');
+    }
+  };
+  run_lines();  // warm-up: the buffers grow to the longest line
+  allocation_tracker::Scope scope;
+  for (int repeat = 0; repeat < 100; ++repeat) {
+    run_lines();
+  }
+  CheckAllocations("split into StringTable, SplitFields, JoinInto (500 lines)", scope, 0);
+
+  scope.Reset();
+  std::vector<std::string> strings = SplitString(kLines[4], ',');
+  // Vector growth, the input copy and long fields: what the StringTable path avoids
+  CheckAllocations("SplitString into vector<string> (5 fields)", scope, 8);
+}
+
+void TestNumberFormatting() {
+  allocation_tracker::Scope scope;
+  char buffer[kHumanReadableBufferSize];
+  uint64_t total_length = 0;
+  for (int64_t value = -1000000; value <= 1000000; value += 997) {
+    total_length += HumanReadableFormatTo(buffer, value * 123457).size();
+  }
+  CheckAllocations("HumanReadableFormatTo (2000 values)", scope, 0);
+
+  scope.Reset();
+  // Short results fit in the string's own buffer
+  total_length += FormatNumber(1234567).size();
+  CheckAllocations("FormatNumber(1234567)", scope, 0);
+  scope.Reset();
+  total_length += FormatNumber(std::numeric_limits<int64_t>::min()).size();
+  CheckAllocations("FormatNumber(INT64_MIN)", scope, 0);
+  if (total_length == 0) {
+    std::cout << "unexpected empty output" << std::endl;
+  }
+}
+
+struct VectorTag {};
+using Counted = CountingValue<std::string, VectorTag>;
+
+void TestVectorConcat() {
+  constexpr size_t kSize = 1000;
+  std::vector<Counted> first(kSize, Counted("a string too long for the small buffer"));
+  std::vector<Counted> second(kSize, Counted("b"));
+  std::vector<Counted> third(kSize, Counted("c"));
+
+  Counted::Scope copies;
+  allocation_tracker::Scope scope;
+  std::vector<Counted> all = VectorConcat(std::move(first), second, std::move(third));
+  CheckBudget("VectorConcat(rvalue, lvalue, rvalue) copies", copies.Counts().Copies(), kSize,
+              "copies");
+  CheckAllocations("VectorConcat(rvalue, lvalue, rvalue)", scope, 1);
+
+  copies.Reset();
+  scope.Reset();
+  std::vector<Counted> destination;
+  VectorAppend(destination, std::move(all));
+  CheckBudget("VectorAppend into empty vector", copies.Counts().Moves() + copies.Counts().Copies(),
+              0, "copies and moves");
+  CheckAllocations("VectorAppend into empty vector", scope, 0);
+
+  copies.Reset();
+  std::vector<std::pair<int, Counted>> pairs;
+  for (int i = 0; i < 10000; ++i) {
+    pairs.emplace_back((i * 7919) % 10007, Counted("x"));
+  }
+  copies.Reset();
+  scope.Reset();
+  SortPairsByFirst(pairs, false, 1);
+  CheckBudget("SortPairsByFirst (10^4 pairs)", copies.Counts().Copies(), 0, "copies");
+  // The scatter buffer plus the digit histograms
+  CheckAllocations("SortPairsByFirst (10^4 pairs)", scope, 8);
+}
+
+int main() {
+  TestStringUtils();
+  TestNumberFormatting();
+  TestVectorConcat();
+  std::cout << "Peak live heap: " << allocation_tracker::PeakLiveBytes() << " bytes" << std::endl;
+  std::cout << (num_failures == 0 ? "All budgets met" : "Budgets EXCEEDED") << std::endl;
+  return num_failures == 0 ? 0 : 1;
+}
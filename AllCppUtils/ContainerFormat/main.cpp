@@ -0,0 +1,109 @@
+#include <unistd.h> // STDOUT_FILENO
+
+#include <array>
+#include <cstdint>
+#include <iomanip> // std::setw
+#include <iostream>
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../common/container_format.hpp"
+#include "../common/vector_ostream.hpp"
+
+struct Point {
+  double x;
+  double y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& p) {
+  os << "(" << p.x << ", " << p.y << ")";
+  return os;
+}
+
+// Recursive type whose operator<< prints its children through the vector operator<<
+struct Tree {
+  int value;
+  std::vector<Tree> children;
+};
+
+std::ostream& operator<<(std::ostream& os, const Tree& tree) {
+  return os << tree.value << tree.children;
+}
+
+int main() {
+  using container_format::Format;
+
+  std::vector<int> empty_vector;
+  std::vector<std::string> strings{"alpha", "beta"};
+  std::map<std::string, std::vector<int>> map_of_vectors{{"odd", {1, 3, 5}}, {"even", {2, 4}}};
+  std::set<char> char_set{'c', 'a', 'b'};
+  std::tuple<int, std::string, double> tuple(7, "seven", 7.5);
+  std::vector<std::optional<int>> optionals{1, std::nullopt, 3};
+  std::variant<int, std::string> variant("text");
+  std::list<std::pair<int, bool>> pair_list{{1, true}, {2, false}};
+  std::array<Point, 2> points{{{0, 1}, {2.5, 3}}};
+
+  std::cout << Format(empty_vector) << std::endl;
+  std::cout << Format(strings) << std::endl;
+  std::cout << Format(map_of_vectors) << std::endl;
+  std::cout << Format(char_set) << std::endl;
+  std::cout << Format(tuple) << std::endl;
+  std::cout << Format(optionals) << std::endl;
+  std::cout << Format(variant) << std::endl;
+  std::cout << Format(pair_list) << std::endl;
+  std::cout << Format(points) << std::endl;
+  std::cout << std::endl;
+
+  // Format specs
+  std::vector<double> doubles{3.14159, -2.5, 1e6};
+  std::vector<int> ints{255, -16, 7};
+  std::cout << Format(doubles, "{:.2f}") << std::endl;
+  std::cout << Format(doubles, "{:>10.3e}") << std::endl;
+  std::cout << Format(ints, "x") << std::endl;
+  std::cout << Format(ints, "{:+06d}") << std::endl;
+  std::cout << Format(ints, "{:*^7}") << std::endl;
+  std::cout << std::endl;
+
+  // Truncation, at every nesting level
+  std::vector<int> big_vector(1000000);
+  for (size_t i = 0; i < big_vector.size(); ++i) {
+    big_vector[i] = static_cast<int>(i);
+  }
+  std::cout << Format(big_vector, "{:|8..2}") << std::endl;
+  std::vector<std::vector<int>> nested(20, std::vector<int>{1, 2, 3, 4, 5, 6});
+  std::cout << Format(nested, "|2..1") << std::endl;
+  std::cout << std::endl;
+
+  // Reusable buffer and FastWriter sinks
+  std::string buffer;
+  for (int i = 0; i < 3; ++i) {
+    buffer.clear();
+    container_format::FormatTo(buffer, std::make_pair(i, i * i));
+    std::cout << buffer << std::endl;
+  }
+  FastWriter writer(STDOUT_FILENO);
+  container_format::FormatTo(writer, map_of_vectors, "|1..0");
+  writer << '\n';
+
+  std::cout << std::endl;
+  // Nested WriteToStream calls for the same type must not share a buffer
+  Tree tree{0, {{1, {{2, {}}, {3, {}}}}, {4, {}}}};
+  std::cout << "Tree: " << tree.children << std::endl;
+  // The stream width pads the whole container and is reset afterwards
+  std::cout << std::setw(12) << std::vector<int>{1, 2} << "|" << std::endl;
+  std::cout << std::left << std::setw(12) << std::vector<int>{1, 2} << "|" << std::right
+            << std::endl;
+  // int8_t / uint8_t are characters, same as std::ostream and FastWriter
+  std::vector<uint8_t> bytes{'A', 'B'};
+  std::cout << "Bytes: " << bytes << " " << Format(std::vector<int8_t>{'x', 'y'}) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <unistd.h> // STDOUT_FILENO
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/common_ostream.hpp"
+#include "../common/fast_writer.hpp"
+#include "../common/timer.hpp"
+
+int main() {
+  {
+    FastWriter writer(STDOUT_FILENO);
+    writer << "int: " << -42 << ", unsigned: " << 42u << ", char: " << 'c' << '\n';
+    writer << "double: " << 3.14159265358979 << ", float: " << 0.1f << '\n';
+    writer.SetFloatPrecision(FastWriter::kShortestFloat);
+    writer << "shortest double: " << 3.14159265358979 << '\n';
+    writer.SetFloatPrecision(6);
+
+    std::vector<int> empty_vector;
+    std::vector<double> double_vector{0.5, 1.25, 1e10};
+    std::vector<std::string> string_vector{"alpha", "beta"};
+    std::vector<std::pair<int, std::string>> pair_vector{{1, "one"}, {2, "two"}};
+    writer << empty_vector << '\n' << double_vector << '\n' << string_vector << '\n';
+    writer << pair_vector << '\n';
+    writer.Flush();
+  }
+
+  // Same dump through std::ostream and FastWriter, timed (output goes to /dev/null)
+  const size_t kNumElements = 10000000;
+  std::vector<int> big_vector(kNumElements);
+  for (size_t i = 0; i < kNumElements; ++i) {
+    big_vector[i] = static_cast<int>(i * 2654435761u);
+  }
+  std::FILE* null_file = std::fopen("/dev/null", "w");
+  Timer timer;
+  {
+    FastWriter writer(null_file);
+    writer << big_vector;
+  }
+  double fast_writer_seconds = timer.GetSeconds();
+  std::ofstream null_stream("/dev/null");
+  timer.Reset();
+  null_stream << big_vector;
+  double ostream_seconds = timer.GetSeconds();
+  std::fclose(null_file);
+
+  std::cout << std::endl << "Dumping " << kNumElements << " ints:" << std::endl;
+  std::cout << "  std::ostream: " << ostream_seconds << " s" << std::endl;
+  std::cout << "  FastWriter:   " << fast_writer_seconds << " s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef FUZZ_INPUT_HPP
+#define FUZZ_INPUT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring> // std::memcpy
+#include <string_view>
+#include <type_traits>
+
+// Reports a failed check and aborts, which libFuzzer records as a crash with the input saved
+#define FUZZ_CHECK(condition)                                                        \
+  do {                                                                               \
+    if (!(condition)) {                                                              \
+      std::fprintf(stderr, "%s:%d: FUZZ_CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #condition);                                                      \
+      __builtin_trap();                                                              \
+    }                                                                                \
+  } while (0)
+
+// Carves typed values out of the fuzzer's byte string without copying or allocating. Reads past
+// the end yield zeros, so every input decodes to something.
+class FuzzInput {
+ public:
+  FuzzInput(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  T Consume() {
+    static_assert(std::is_trivially_copyable<T>::value, "Trivially copyable type required");
+    T value{};
+    size_t num_bytes = sizeof(T) < size_ ? sizeof(T) : size_;
+    std::memcpy(&value, data_, num_bytes);
+    data_ += num_bytes;
+    size_ -= num_bytes;
+    return value;
+  }
+
+  // Integer in [min_value, max_value]
+  template <typename IntType>
+  IntType ConsumeInRange(IntType min_value, IntType max_value) {
+    using UnsignedType = std::make_unsigned_t<IntType>;
+    UnsignedType range =
+        static_cast<UnsignedType>(max_value) - static_cast<UnsignedType>(min_value);
+    UnsignedType raw = Consume<UnsignedType>();
+    if (range != static_cast<UnsignedType>(-1)) {
+      raw %= range + 1;
+    }
+    return static_cast<IntType>(static_cast<UnsignedType>(min_value) + raw);
+  }
+
+  bool ConsumeBool() { return Consume<uint8_t>() & 1; }
+
+  // The next length bytes (fewer at the end of the input)
+  std::string_view ConsumeBytes(size_t length) {
+    length = length < size_ ? length : size_;
+    std::string_view bytes(reinterpret_cast<const char*>(data_), length);
+    data_ += length;
+    size_ -= length;
+    return bytes;
+  }
+
+  std::string_view ConsumeRemainingBytes() { return ConsumeBytes(size_); }
+
+  size_t RemainingBytes() const { return size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+};
+
+#endif  // FUZZ_INPUT_HPP
@@ -0,0 +1,171 @@
+// FormatNumber, HumanReadableFormat, FloatToSigFigs and IntSciNotation against independent
+// references: the original FormatNumber loop in 128-bit integers, exact 128-bit rounding, and
+// printf
+#include <cmath>
+#include <cstdint>
+#include <cstdio> // std::snprintf
+#include <cstdlib> // std::strtod, std::atoi
+#include <cstring> // std::strchr, std::strlen
+#include <string>
+#include <string_view>
+
+#include "../HumanReadableNumber/human_readable_number.hpp"
+#include "../ReadableNumberFormatting/format_number.hpp"
+#include "fuzz_input.hpp"
+
+namespace {
+
+// Writes the decimal digits of magnitude into buffer (no terminator), returns their count
+int WriteDigits(unsigned __int128 magnitude, char* buffer) {
+  char reversed[48];
+  int num_digits = 0;
+  do {
+    reversed[num_digits++] = static_cast<char>('0' + static_cast<int>(magnitude % 10));
+    magnitude /= 10;
+  } while (magnitude != 0);
+  for (int i = 0; i < num_digits; ++i) {
+    buffer[i] = reversed[num_digits - 1 - i];
+  }
+  return num_digits;
+}
+
+template <typename IntType>
+unsigned __int128 Magnitude(IntType value) {
+  // Widening first keeps the most negative value representable
+  __int128 wide = value;
+  return static_cast<unsigned __int128>(wide < 0 ? -wide : wide);
+}
+
+// The original FormatNumber: scale by 10 for one decimal, divide by 1000 until below 10000,
+// show the decimal if nonzero and the sign and integer part take fewer than 3 chars. 128-bit
+// arithmetic keeps num * 10 and the most negative value from overflowing.
+template <typename IntType>
+std::string_view ReferenceFormatNumber(IntType value, char (&buffer)[64]) {
+  static const char* const kSuffixes[] = {"K", "M", "B", "T", "P", "E"};
+  unsigned __int128 scaled = Magnitude(value) * 10;
+  int suffix_index = -1;
+  while (scaled >= 10000) {
+    scaled /= 1000;
+    ++suffix_index;
+  }
+  size_t length = 0;
+  if (value < 0) {
+    buffer[length++] = '-';
+  }
+  length += WriteDigits(scaled / 10, buffer + length);
+  int decimal = static_cast<int>(scaled % 10);
+  if (decimal != 0 && length < 3) {
+    buffer[length++] = '.';
+    buffer[length++] = static_cast<char>('0' + decimal);
+  }
+  if (suffix_index >= 0) {
+    buffer[length++] = ' ';
+    for (const char* suffix = kSuffixes[suffix_index]; *suffix != '\0'; ++suffix) {
+      buffer[length++] = *suffix;
+    }
+  }
+  return std::string_view(buffer, length);
+}
+
+// Rounds half up to sig_figs digits in 128-bit integers, then places the decimal point before
+// the K/M/B/T/P/E suffix
+template <typename IntType>
+std::string_view ReferenceHumanReadable(IntType value, int sig_figs, char (&buffer)[64]) {
+  static const char* const kSuffixes[] = {"", "K", "M", "B", "T", "P", "E"};
+  sig_figs = sig_figs < 1 ? 1 : (sig_figs > 19 ? 19 : sig_figs);
+  unsigned __int128 magnitude = Magnitude(value);
+  size_t length = 0;
+  if (value < 0) {
+    buffer[length++] = '-';
+  }
+  if (magnitude < 1000) {
+    length += WriteDigits(magnitude, buffer + length);
+    return std::string_view(buffer, length);
+  }
+  char digits[48];
+  int num_digits = WriteDigits(magnitude, digits);
+  unsigned __int128 rounded = magnitude;
+  int exponent = num_digits - 1;
+  if (num_digits > sig_figs) {
+    unsigned __int128 divisor = 1;
+    for (int i = 0; i < num_digits - sig_figs; ++i) {
+      divisor *= 10;
+    }
+    rounded = magnitude / divisor + (magnitude % divisor >= divisor / 2 ? 1 : 0);
+    if (WriteDigits(rounded, digits) > sig_figs) {
+      rounded /= 10;
+      ++exponent;
+    }
+  } else {
+    for (int i = num_digits; i < sig_figs; ++i) {
+      rounded *= 10;
+    }
+  }
+  WriteDigits(rounded, digits);
+  int suffix_index = exponent / 3;
+  int integer_digits = exponent % 3 + 1;
+  for (int i = 0; i < integer_digits; ++i) {
+    buffer[length++] = i < sig_figs ? digits[i] : '0';
+  }
+  if (sig_figs > integer_digits) {
+    buffer[length++] = '.';
+    for (int i = integer_digits; i < sig_figs; ++i) {
+      buffer[length++] = digits[i];
+    }
+  }
+  for (const char* suffix = kSuffixes[suffix_index]; *suffix != '\0'; ++suffix) {
+    buffer[length++] = *suffix;
+  }
+  return std::string_view(buffer, length);
+}
+
+// Same printf reference as HumanReadableNumber/test.cpp
+std::string_view ReferenceSigFigs(double value, int sig_figs, char (&buffer)[128]) {
+  char scientific[64];
+  std::snprintf(scientific, sizeof(scientific), "%.*e", sig_figs - 1, value);
+  int exponent = std::atoi(std::strchr(scientific, 'e') + 1);
+  if (exponent >= sig_figs - 1) {
+    std::snprintf(buffer, sizeof(buffer), "%.0f", std::strtod(scientific, nullptr));
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%.*f", sig_figs - 1 - exponent, value);
+  }
+  return std::string_view(buffer, std::strlen(buffer));
+}
+
+template <typename IntType>
+void CheckInteger(IntType value, int sig_figs) {
+  char expected[64];
+  FUZZ_CHECK(FormatNumber(value) == ReferenceFormatNumber(value, expected));
+  char buffer[kHumanReadableBufferSize];
+  FUZZ_CHECK(HumanReadableFormatTo(buffer, value, sig_figs) ==
+             ReferenceHumanReadable(value, sig_figs, expected));
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput input(data, size);
+  int sig_figs = input.ConsumeInRange(-2, 21);
+  CheckInteger(input.Consume<int32_t>(), sig_figs);
+  CheckInteger(input.Consume<int64_t>(), sig_figs);
+  CheckInteger(input.Consume<uint64_t>(), sig_figs);
+
+  // Doubles of either sign within fixed notation, where the printf reference applies: the
+  // mantissa is normalized to [1, 10) so the exponent alone sets the magnitude
+  double mantissa = 1.0 + 9.0 * (static_cast<double>(input.Consume<uint32_t>()) / 4294967296.0);
+  mantissa = input.ConsumeBool() ? -mantissa : mantissa;
+  int exponent = input.ConsumeInRange(-15, 15);
+  double value = mantissa * std::pow(10.0, exponent);
+  int float_sig_figs = input.ConsumeInRange(1, 6);
+  char expected[128];
+  FUZZ_CHECK(FloatToSigFigs(value, float_sig_figs) ==
+             ReferenceSigFigs(value, float_sig_figs, expected));
+
+  // Integers converted to double exactly, so printf rounds the same digits
+  int64_t integer = input.ConsumeInRange<int64_t>(-(int64_t{1} << 53), int64_t{1} << 53);
+  int sci_sig_figs = input.ConsumeInRange(1, 17);
+  std::snprintf(expected, sizeof(expected), "%.*e", sci_sig_figs - 1,
+                static_cast<double>(integer));
+  FUZZ_CHECK(IntSciNotation(integer, sci_sig_figs) == expected);
+  return 0;
+}
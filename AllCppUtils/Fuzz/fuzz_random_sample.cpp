@@ -0,0 +1,48 @@
+// RandomSample against RandomSampleNaive for the same seeded engine, plus the sample properties:
+// distinct values in [0, num_elements), and invalid arguments rejected
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../RandomSample/random_sample.hpp"
+#include "fuzz_input.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  // The naive version allocates num_elements, keep it small enough for fast iterations
+  constexpr int kMaxElements = 4096;
+  FuzzInput input(data, size);
+  uint64_t seed = input.Consume<uint64_t>();
+  int num_elements = input.ConsumeInRange(0, kMaxElements);
+  int num_samples = input.ConsumeInRange(-2, kMaxElements + 2);
+  std::mt19937_64 engine(seed);
+  std::mt19937_64 naive_engine(seed);
+  if (num_samples < 0 || num_samples > num_elements) {
+    bool threw = false;
+    try {
+      RandomSample(num_samples, num_elements, engine);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    FUZZ_CHECK(threw);
+    return 0;
+  }
+  std::vector<int> sample = RandomSample(num_samples, num_elements, engine);
+  FUZZ_CHECK(sample == RandomSampleNaive(num_samples, num_elements, naive_engine));
+  FUZZ_CHECK(sample.size() == static_cast<size_t>(num_samples));
+  // Seen marks are cleared after each input, so the array is never reallocated or rescanned
+  static bool seen[kMaxElements];
+  bool distinct = true;
+  for (int value : sample) {
+    FUZZ_CHECK(value >= 0 && value < num_elements);
+    distinct = distinct && !seen[value];
+    seen[value] = true;
+  }
+  for (int value : sample) {
+    seen[value] = false;
+  }
+  FUZZ_CHECK(distinct);
+  // Both engines made the same draws
+  FUZZ_CHECK(engine() == naive_engine());
+  return 0;
+}
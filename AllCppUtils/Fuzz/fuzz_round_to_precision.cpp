@@ -0,0 +1,60 @@
+// Batch RoundToPrecision (AVX in kBinary mode) against the scalar functions, for doubles and
+// floats of any bit pattern, including NaNs, infinities and denormals
+#include <cmath>
+#include <cstdint>
+#include <cstring> // std::memcmp, std::memcpy
+
+#include "../RoundToPrecision/round_to_precision.hpp"
+#include "fuzz_input.hpp"
+
+namespace {
+
+// Equal results, or both NaN (payloads may differ)
+template <typename FloatType>
+bool SameResult(FloatType left, FloatType right) {
+  if (std::isnan(left) || std::isnan(right)) {
+    return std::isnan(left) && std::isnan(right);
+  }
+  return std::memcmp(&left, &right, sizeof(FloatType)) == 0;
+}
+
+template <typename FloatType>
+void CheckBatch(FuzzInput& input, int precision) {
+  // Up to 37 values, so the AVX loop and its scalar tail both run
+  constexpr size_t kMaxCount = 37;
+  static FloatType values[kMaxCount];
+  static FloatType output[kMaxCount];
+  size_t count = input.ConsumeInRange<size_t>(0, kMaxCount);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = input.Consume<FloatType>();
+  }
+  RoundToPrecision(values, output, count, precision);
+  for (size_t i = 0; i < count; ++i) {
+    FUZZ_CHECK(SameResult(output[i], RoundToPrecision(values[i], precision)));
+  }
+  RoundToPrecision(values, output, count, precision, RoundingMode::kDecimalExact);
+  for (size_t i = 0; i < count; ++i) {
+    FUZZ_CHECK(SameResult(output[i], RoundToPrecisionDecimal(values[i], precision)));
+    // Rounding an already rounded value changes nothing
+    FUZZ_CHECK(SameResult(output[i], RoundToPrecisionDecimal(output[i], precision)));
+  }
+  // In place, input and output the same array
+  std::memcpy(output, values, count * sizeof(FloatType));
+  RoundToPrecision(output, output, count, precision);
+  for (size_t i = 0; i < count; ++i) {
+    FUZZ_CHECK(SameResult(output[i], RoundToPrecision(values[i], precision)));
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput input(data, size);
+  int precision = input.ConsumeInRange(-40, 40);
+  if (input.ConsumeBool()) {
+    CheckBatch<double>(input, precision);
+  } else {
+    CheckBatch<float>(input, precision);
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+// SplitString and SplitFields against a byte-by-byte reference splitter
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../LineReader/line_reader.hpp"
+#include "../StringSplitJoin/string_split.hpp"
+#include "../StringSplitJoin/string_table.hpp"
+#include "fuzz_input.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput input(data, size);
+  char delim = static_cast<char>(input.Consume<uint8_t>());
+  bool retain_empty = input.ConsumeBool();
+  std::string_view text = input.ConsumeRemainingBytes();
+
+  // Reused across iterations, so SplitFields does not allocate once it has grown
+  static std::vector<std::string_view> fields;
+  static StringTable table;
+  SplitFields(text, delim, fields, retain_empty);
+  SplitString(text, delim, table, retain_empty);
+  std::vector<std::string> split_strings = SplitString(std::string(text), delim, retain_empty);
+  FUZZ_CHECK(split_strings.size() == fields.size());
+  FUZZ_CHECK(table.size() == fields.size());
+
+  size_t num_fields = 0;
+  size_t start_i = 0;
+  for (size_t i = 0; i <= text.size(); ++i) {
+    if (i < text.size() && text[i] != delim) {
+      continue;
+    }
+    if (i > start_i || retain_empty) {
+      std::string_view expected = text.substr(start_i, i - start_i);
+      FUZZ_CHECK(num_fields < fields.size());
+      FUZZ_CHECK(fields[num_fields] == expected);
+      FUZZ_CHECK(split_strings[num_fields] == expected);
+      FUZZ_CHECK(table[num_fields] == expected);
+      // Fields must be views into the input, not copies
+      FUZZ_CHECK(fields[num_fields].data() == text.data() + start_i || expected.empty());
+      ++num_fields;
+    }
+    start_i = i + 1;
+  }
+  FUZZ_CHECK(num_fields == fields.size());
+
+  // Appending a table's own element, which may move the buffer it points into
+  if (!table.empty()) {
+    size_t num_chars = table.NumChars();
+    size_t middle_i = table.size() / 2;
+    table.push_back(table[middle_i]);
+    FUZZ_CHECK(table.back() == table[middle_i]);
+    FUZZ_CHECK(table.NumChars() == num_chars + table[middle_i].size());
+  }
+  return 0;
+}
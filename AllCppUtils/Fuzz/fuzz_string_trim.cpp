@@ -0,0 +1,53 @@
+// SSE2 trims against scalar loops over the "C" locale whitespace set
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../StringTrim/string_trim.hpp"
+#include "fuzz_input.hpp"
+
+namespace {
+
+bool IsSpaceReference(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v' || ch == '\f' || ch == '\r';
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput input(data, size);
+  std::string_view text = input.ConsumeRemainingBytes();
+
+  size_t begin = 0;
+  while (begin < text.size() && IsSpaceReference(text[begin])) {
+    ++begin;
+  }
+  size_t end = text.size();
+  while (end > begin && IsSpaceReference(text[end - 1])) {
+    --end;
+  }
+  size_t right_end = text.size();
+  while (right_end > 0 && IsSpaceReference(text[right_end - 1])) {
+    --right_end;
+  }
+
+  std::string_view left = LtrimView(text);
+  std::string_view right = RtrimView(text);
+  std::string_view both = TrimView(text);
+  FUZZ_CHECK(left.data() == text.data() + begin && left.size() == text.size() - begin);
+  FUZZ_CHECK(right.data() == text.data() && right.size() == right_end);
+  FUZZ_CHECK(both == text.substr(begin, end - begin));
+
+  // In-place versions, on a string whose capacity is reused across iterations
+  static std::string buffer;
+  buffer.assign(text.data(), text.size());
+  Trim(buffer);
+  FUZZ_CHECK(buffer == both);
+  buffer.assign(text.data(), text.size());
+  Ltrim(buffer);
+  FUZZ_CHECK(buffer == left);
+  buffer.assign(text.data(), text.size());
+  Rtrim(buffer);
+  FUZZ_CHECK(buffer == right);
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Stand-alone driver for the fuzz targets when libFuzzer is not available (e.g. with g++).
+// Replays the inputs given as arguments, files or directories of files (such as a libFuzzer
+// corpus or crash-* reproducers), or without arguments runs random inputs:
+//
+//   T=fuzz_string_split
+//   g++ -std=c++17 -O2 -g -fsanitize=address,undefined $T.cpp replay_main.cpp -o $T
+//   ./$T [-runs=N] [-seed=S] [-max_len=L] [file or directory ...]
+//
+// With clang, build the same target for coverage-guided fuzzing by linking libFuzzer instead:
+//
+//   clang++ -std=c++17 -O1 -g -fsanitize=fuzzer,address,undefined $T.cpp -o $T
+//   ./$T -max_total_time=60 corpus/
+#include <algorithm> // std::copy
+#include <cstdint>
+#include <cstdlib> // std::strtoull
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+// Each input gets its own exact-size allocation, so sanitizers catch reads past its end
+void RunInput(const uint8_t* data, size_t size) {
+  std::unique_ptr<uint8_t[]> copy(new uint8_t[size == 0 ? 1 : size]);
+  std::copy(data, data + size, copy.get());
+  LLVMFuzzerTestOneInput(copy.get(), size);
+}
+
+size_t ReplayFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+  RunInput(contents.data(), contents.size());
+  return 1;
+}
+
+uint64_t SplitMix64(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Flags look like libFuzzer's, "-name=value"
+bool ParseFlag(std::string_view arg, std::string_view name, uint64_t& value) {
+  if (arg.size() <= name.size() + 2 || arg[0] != '-' || arg.substr(1, name.size()) != name ||
+      arg[name.size() + 1] != '=') {
+    return false;
+  }
+  value = std::strtoull(std::string(arg.substr(name.size() + 2)).c_str(), nullptr, 10);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t num_runs = 100000;
+  uint64_t seed = 1;
+  uint64_t max_len = 256;
+  std::vector<std::filesystem::path> paths;
+  for (int arg_i = 1; arg_i < argc; ++arg_i) {
+    std::string_view arg = argv[arg_i];
+    if (!ParseFlag(arg, "runs", num_runs) && !ParseFlag(arg, "seed", seed) &&
+        !ParseFlag(arg, "max_len", max_len)) {
+      paths.emplace_back(arg);
+    }
+  }
+
+  if (!paths.empty()) {
+    size_t num_inputs = 0;
+    for (const std::filesystem::path& path : paths) {
+      if (std::filesystem::is_directory(path)) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+          if (entry.is_regular_file()) {
+            num_inputs += ReplayFile(entry.path());
+          }
+        }
+      } else {
+        num_inputs += ReplayFile(path);
+      }
+    }
+    std::cout << "Replayed " << num_inputs << " inputs" << std::endl;
+    return 0;
+  }
+
+  // Random inputs: mostly short, since the targets decode small headers first
+  uint64_t state = seed;
+  std::vector<uint8_t> buffer(max_len);
+  for (uint64_t run = 0; run < num_runs; ++run) {
+    size_t size = SplitMix64(state) % (max_len + 1);
+    if (SplitMix64(state) % 2 == 0) {
+      size = size % 17;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      // Few distinct byte values, so delimiters and whitespace come up often
+      uint64_t random = SplitMix64(state);
+      buffer[i] = static_cast<uint8_t>(random % 4 == 0 ? "\t\n ,\r\v\f\0"[(random >> 8) % 8] :
+                                       random >> 16);
+    }
+    RunInput(buffer.data(), size);
+  }
+  std::cout << "Ran " << num_runs << " random inputs (seed " << seed << ")" << std::endl;
+  return 0;
+}
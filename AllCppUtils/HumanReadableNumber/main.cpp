@@ -34,5 +34,15 @@ int main() {
   std::cout << std::endl << "2^32 - 1 = " << HumanReadableFormat(4294967295) << std::endl;
   std::cout << std::endl << "2^64 - 1 = " << HumanReadableFormat(18446744073709551615UL) << std::endl;
   
+  std::cout << std::endl;
+  TestHumanReadableFormat(999499);
+  TestHumanReadableFormat(999500);
+  TestHumanReadableFormat(-9223372036854775807 - 1);
+  
+  std::cout << std::endl;
+  char buffer[kHumanReadableBufferSize];
+  std::cout << "1 sig fig: " << HumanReadableFormatTo(buffer, 452316167, 1) << std::endl;
+  std::cout << "5 sig figs: " << HumanReadableFormatTo(buffer, 1500, 5) << std::endl;
+  
   return 0;
 }
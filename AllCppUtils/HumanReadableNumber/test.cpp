@@ -1,27 +1,27 @@
 #include <cmath>
-#include <cstdlib> // std::to_string
-#include <iomanip> // std::setprecision
+#include <cstdint>
+#include <cstdio> // std::snprintf
+#include <cstdlib> // std::strtod, std::atoi
+#include <cstring> // std::strchr
 #include <iostream>
-#include <sstream>
+#include <random>
 #include <string>
-#include <vector>
 
-// Generate string representing a float rounded to given number of significant figures
-template <typename FloatType>
-std::string FloatToSigFigs(FloatType value, int sig_figs) {
-  static_assert(std::is_floating_point<FloatType>::value, "Float type required");
-  int digits_before_decimal = (value > 1) ? std::floor(std::log10(value)) + 1 : 1;
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(sig_figs - digits_before_decimal) << value;
-  return ss.str();
-}  
+#include "human_readable_number.hpp"
 
-template <typename IntType>
-std::string IntSciNotation(IntType value, int sig_figs) {
-  static_assert(std::is_integral<IntType>::value, "Integral type required");
-  std::stringstream ss;
-  ss << std::scientific << std::setprecision(sig_figs - 1) << static_cast<double>(value);
-  return ss.str();
+// printf-based reference: round with %.*e, then lay the rounded value out in fixed notation
+std::string ReferenceSigFigs(double value, int sig_figs) {
+  char scientific[64];
+  std::snprintf(scientific, sizeof(scientific), "%.*e", sig_figs - 1, value);
+  int exponent = std::atoi(std::strchr(scientific, 'e') + 1);
+  char fixed[128];
+  if (exponent >= sig_figs - 1) {
+    // No decimals: print the rounded value itself
+    std::snprintf(fixed, sizeof(fixed), "%.0f", std::strtod(scientific, nullptr));
+  } else {
+    std::snprintf(fixed, sizeof(fixed), "%.*f", sig_figs - 1 - exponent, value);
+  }
+  return fixed;
 }
 
 int main() {
@@ -31,6 +31,41 @@ int main() {
   std::cout << FloatToSigFigs(1.0, 3) << std::endl;
   std::cout << FloatToSigFigs(10.0, 3) << std::endl;
   std::cout << FloatToSigFigs(100.0, 5) << std::endl;
-  
+  std::cout << FloatToSigFigs(-123.45678, 3) << std::endl;
+  std::cout << FloatToSigFigs(0.00123456, 3) << std::endl;
+  std::cout << FloatToSigFigs(9.9996, 4) << std::endl;
+  std::cout << FloatToSigFigs(123456.0, 2) << std::endl;
+  std::cout << std::endl;
+
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> mantissa_dist(-10.0, 10.0);
+  int num_failures = 0;
+  for (int i = 0; i < 500000; ++i) {
+    // Exponents within the fixed notation range, mantissa digits exact in a double
+    double value = mantissa_dist(rng) * std::pow(10.0, static_cast<int>(rng() % 31) - 15);
+    int sig_figs = 1 + static_cast<int>(rng() % 6);
+    std::string expected = ReferenceSigFigs(value, sig_figs);
+    std::string actual = FloatToSigFigs(value, sig_figs);
+    if (actual != expected && ++num_failures <= 5) {
+      std::cout << "FloatToSigFigs(" << value << ", " << sig_figs << ") = " << actual
+                << ", printf: " << expected << std::endl;
+    }
+  }
+  std::cout << "FloatToSigFigs vs printf: " << num_failures << " failures" << std::endl;
+
+  num_failures = 0;
+  char expected[64];
+  for (int i = 0; i < 500000; ++i) {
+    int64_t value = static_cast<int64_t>(rng() >> (rng() % 64));
+    int sig_figs = 1 + static_cast<int>(rng() % 17);
+    std::snprintf(expected, sizeof(expected), "%.*e", sig_figs - 1, static_cast<double>(value));
+    if (IntSciNotation(value, sig_figs) != expected && ++num_failures <= 5) {
+      std::cout << "IntSciNotation(" << value << ", " << sig_figs
+                << ") = " << IntSciNotation(value, sig_figs) << ", printf: " << expected
+                << std::endl;
+    }
+  }
+  std::cout << "IntSciNotation vs printf: " << num_failures << " failures" << std::endl;
+
   return 0;
 }
@@ -1,23 +1,209 @@
+#ifndef INT_POWER_HPP
+#define INT_POWER_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
+#include <utility> // std::move
 
-// Fast int power function, assumes exponent is non-negative
+// Fast int power function, assumes exponent is non-negative. Overflow wraps around (the math is
+// done unsigned, so it is never UB), and base is not squared after the last multiply so results
+// that fit are always exact.
 template <typename BaseType, typename ExpType>
-BaseType IntPower(BaseType base, ExpType exponent) {
+constexpr BaseType IntPower(BaseType base, ExpType exponent) {
   static_assert(std::is_integral<BaseType>::value, "Integral type required for base");
   static_assert(std::is_integral<ExpType>::value, "Integral type required for exponent");
-  BaseType result = 1;
+  // At least unsigned int wide, so small types are not promoted to (overflowing) signed int
+  using UnsignedType = typename std::conditional<sizeof(BaseType) < sizeof(unsigned), unsigned,
+                                                 std::make_unsigned_t<BaseType>>::type;
+  UnsignedType magnitude = static_cast<UnsignedType>(base);
+  bool negate = false;
   if (base < 0) {
-    result *= (exponent & 1) ? -1 : 1;
-    base *= -1;
+    magnitude = 0 - magnitude;
+    negate = exponent & 1;
   }
+  UnsignedType result = 1;
   while (exponent > 0) {
     if (exponent & 1) {
-       result *= base;
+      result *= magnitude;
     }
-    // Now exponent is even
     exponent /= 2;
-    base *= base;
+    if (exponent > 0) {
+      magnitude *= magnitude;
+    }
+  }
+  return static_cast<BaseType>(negate ? 0 - result : result);
+}
+
+// Exponentiation by squaring over any monoid: op must be associative with op(identity, x) == x.
+// Works for matrices, affine transforms, permutations, ..., using O(log exponent) applications of
+// op. Assumes exponent is non-negative.
+template <typename T, typename ExpType, typename Op>
+constexpr T Power(T base, ExpType exponent, Op op, T identity) {
+  static_assert(std::is_integral<ExpType>::value, "Integral type required for exponent");
+  T result = std::move(identity);
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = op(result, base);
+    }
+    exponent /= 2;
+    if (exponent > 0) {
+      base = op(base, base);
+    }
+  }
+  return result;
+}
+
+// IntPower that returns std::nullopt instead of wrapping when the result does not fit BaseType
+template <typename BaseType, typename ExpType>
+constexpr std::optional<BaseType> CheckedIntPower(BaseType base, ExpType exponent) {
+  static_assert(std::is_integral<BaseType>::value, "Integral type required for base");
+  static_assert(std::is_integral<ExpType>::value, "Integral type required for exponent");
+  BaseType result = 1;
+  while (exponent > 0) {
+    if ((exponent & 1) && __builtin_mul_overflow(result, base, &result)) {
+      return std::nullopt;
+    }
+    exponent /= 2;
+    // Squaring only overflows when more multiplies are still needed, and |base| >= 2 then
+    if (exponent > 0 && __builtin_mul_overflow(base, base, &base)) {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
+// IntPower clamped to the min / max of BaseType on overflow
+template <typename BaseType, typename ExpType>
+constexpr BaseType SaturatingIntPower(BaseType base, ExpType exponent) {
+  std::optional<BaseType> result = CheckedIntPower(base, exponent);
+  if (result) {
+    return *result;
+  }
+  bool negative = base < 0 && (exponent & 1);
+  return negative ? std::numeric_limits<BaseType>::min() : std::numeric_limits<BaseType>::max();
+}
+
+// Number of powers base^0, base^1, ... that fit in IntType
+template <typename IntType, IntType kBase>
+constexpr size_t NumRepresentablePowers() {
+  static_assert(kBase >= 2, "Base must be at least 2");
+  size_t count = 1;
+  for (IntType power = 1; power <= std::numeric_limits<IntType>::max() / kBase; power *= kBase) {
+    ++count;
+  }
+  return count;
+}
+
+// Compile-time table of every power of kBase that fits in IntType, e.g.
+// MakePowerTable<uint64_t, 10>() is {1, 10, ..., 10^19}
+template <typename IntType, IntType kBase = 10>
+constexpr std::array<IntType, NumRepresentablePowers<IntType, kBase>()> MakePowerTable() {
+  std::array<IntType, NumRepresentablePowers<IntType, kBase>()> table{};
+  IntType power = 1;
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = power;
+    if (i + 1 < table.size()) {
+      power *= kBase;
+    }
+  }
+  return table;
+}
+
+// Montgomery arithmetic modulo an odd 64-bit modulus: values are kept as a * 2^64 mod n so a
+// modular multiply is two 64x64->128 multiplies and no division. Build one context per modulus
+// and reuse it (e.g. for every base of a Miller-Rabin test).
+class Montgomery64 {
+ public:
+  explicit constexpr Montgomery64(uint64_t modulus) :
+      modulus_(modulus), inverse_(Inverse(modulus)), r_squared_(RSquared(modulus)) {}
+
+  constexpr uint64_t Modulus() const { return modulus_; }
+
+  constexpr uint64_t ToMontgomery(uint64_t value) const {
+    return Reduce(static_cast<unsigned __int128>(value % modulus_) * r_squared_);
+  }
+
+  constexpr uint64_t FromMontgomery(uint64_t value) const {
+    return Reduce(value);
+  }
+
+  constexpr uint64_t Multiply(uint64_t left, uint64_t right) const {
+    return Reduce(static_cast<unsigned __int128>(left) * right);
+  }
+
+  // base^exponent mod n, with base and result in normal (not Montgomery) form
+  constexpr uint64_t Pow(uint64_t base, uint64_t exponent) const {
+    uint64_t result = ToMontgomery(1);
+    uint64_t power = ToMontgomery(base);
+    while (exponent > 0) {
+      if (exponent & 1) {
+        result = Multiply(result, power);
+      }
+      exponent >>= 1;
+      if (exponent > 0) {
+        power = Multiply(power, power);
+      }
+    }
+    return FromMontgomery(result);
+  }
+
+ private:
+  uint64_t modulus_;
+  uint64_t inverse_;  // modulus^-1 mod 2^64
+  uint64_t r_squared_;  // 2^128 mod modulus
+
+  static constexpr uint64_t Inverse(uint64_t modulus) {
+    // Newton's iteration doubles the correct low bits each step, modulus * modulus == 1 mod 8
+    uint64_t inverse = modulus;
+    for (int i = 0; i < 5; ++i) {
+      inverse *= 2 - modulus * inverse;
+    }
+    return inverse;
+  }
+
+  static constexpr uint64_t RSquared(uint64_t modulus) {
+    uint64_t r = (0 - modulus) % modulus;  // 2^64 mod modulus
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(r) * r % modulus);
+  }
+
+  // value * 2^-64 mod n for value < n * 2^64
+  constexpr uint64_t Reduce(unsigned __int128 value) const {
+    uint64_t high = static_cast<uint64_t>(value >> 64);
+    uint64_t m = static_cast<uint64_t>(value) * inverse_;
+    uint64_t mn_high = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * modulus_) >> 64);
+    // value - m * n is divisible by 2^64 and the low halves cancel exactly
+    return (high >= mn_high) ? high - mn_high : high - mn_high + modulus_;
+  }
+};
+
+// base^exponent mod modulus for 64-bit moduli. Odd moduli use Montgomery multiplication, even
+// ones fall back to 128-bit multiply and divide. Throws std::invalid_argument for a zero modulus.
+constexpr uint64_t PowMod(uint64_t base, uint64_t exponent, uint64_t modulus) {
+  if (modulus == 0) {
+    throw std::invalid_argument("PowMod: modulus must be nonzero");
+  }
+  if (modulus == 1) {
+    return 0;
+  }
+  if (modulus & 1) {
+    return Montgomery64(modulus).Pow(base, exponent);
+  }
+  uint64_t result = 1;
+  base %= modulus;
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = static_cast<uint64_t>(static_cast<unsigned __int128>(result) * base % modulus);
+    }
+    exponent >>= 1;
+    if (exponent > 0) {
+      base = static_cast<uint64_t>(static_cast<unsigned __int128>(base) * base % modulus);
+    }
   }
   return result;
 }
 
+#endif  // INT_POWER_HPP
@@ -1,7 +1,35 @@
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
 
 #include "int_power.hpp"
 
+// Plain 128-bit reference for PowMod
+uint64_t NaivePowMod(uint64_t base, uint64_t exponent, uint64_t modulus) {
+  unsigned __int128 result = 1 % modulus;
+  unsigned __int128 power = base % modulus;
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = result * power % modulus;
+    }
+    power = power * power % modulus;
+    exponent >>= 1;
+  }
+  return static_cast<uint64_t>(result);
+}
+
+template <typename T>
+void PrintChecked(std::optional<T> value) {
+  if (value) {
+    std::cout << +*value << std::endl;
+  } else {
+    std::cout << "(overflow)" << std::endl;
+  }
+}
+
 int main() {
   std::cout << IntPower(4, 6) << std::endl;
   std::cout << IntPower(1, 2345634) << std::endl;
@@ -10,6 +38,76 @@ int main() {
   std::cout << IntPower(-5, 2) << std::endl;
   std::cout << IntPower(-1, 4235) << std::endl;
   std::cout << IntPower(-45, 3) << std::endl;
-  
+  std::cout << std::endl;
+
+  // Evaluated at compile time
+  static_assert(IntPower(3, 4) == 81, "IntPower is constexpr");
+  static_assert(IntPower<int64_t>(-2, 63) == INT64_MIN, "No early overflow from the last squaring");
+  static_assert(!CheckedIntPower<int32_t>(2, 31), "2^31 overflows int32");
+  constexpr auto kPowersOfTen = MakePowerTable<uint64_t, 10>();
+  static_assert(kPowersOfTen.size() == 20 && kPowersOfTen[19] == 10000000000000000000ULL, "");
+  std::cout << "Powers of 10 in uint64: " << kPowersOfTen.size() << ", powers of 3 in int32: "
+            << MakePowerTable<int32_t, 3>().size() << std::endl;
+
+  std::cout << "IntPower<int8_t>(-2, 7) = " << +IntPower<int8_t>(-2, 7) << std::endl;
+  std::cout << "CheckedIntPower<int8_t>(-2, 7) = ";
+  PrintChecked(CheckedIntPower<int8_t>(-2, 7));
+  std::cout << "CheckedIntPower<int8_t>(2, 7) = ";
+  PrintChecked(CheckedIntPower<int8_t>(2, 7));
+  std::cout << "CheckedIntPower(10, 18) = ";
+  PrintChecked(CheckedIntPower<int64_t>(10, 18));
+  std::cout << "SaturatingIntPower(10, 19) = " << SaturatingIntPower<int64_t>(10, 19) << std::endl;
+  std::cout << "SaturatingIntPower(-10, 19) = " << SaturatingIntPower<int64_t>(-10, 19)
+            << std::endl;
+  std::cout << std::endl;
+
+  static_assert(PowMod(2, 10, 1000) == 24, "PowMod is constexpr");
+  std::cout << "PowMod(2, 10^18, 10^9 + 7) = " << PowMod(2, 1000000000000000000ULL, 1000000007)
+            << std::endl;
+  std::cout << "PowMod(3, 2^64 - 1, 2^64 - 59) = "
+            << PowMod(3, UINT64_MAX, 18446744073709551557ULL) << std::endl;
+  try {
+    PowMod(2, 10, 0);
+    std::cout << "PowMod(2, 10, 0) did not throw" << std::endl;
+  } catch (const std::invalid_argument& e) {
+    std::cout << "PowMod(2, 10, 0) throws: " << e.what() << std::endl;
+  }
+
+  std::mt19937_64 rng(1);
+  int num_failures = 0;
+  for (int i = 0; i < 200000; ++i) {
+    uint64_t base = rng();
+    uint64_t exponent = rng() >> (rng() % 64);
+    uint64_t modulus = (rng() >> (rng() % 64)) | 1;
+    if (i % 4 == 0) {
+      modulus &= ~1ULL;  // Even moduli take the fallback path
+    }
+    if (modulus == 0) {
+      continue;
+    }
+    if (PowMod(base, exponent, modulus) != NaivePowMod(base, exponent, modulus)) {
+      ++num_failures;
+    }
+  }
+  std::cout << "PowMod vs 128-bit reference: " << num_failures << " failures" << std::endl;
+
+  // Same odd modulus, many exponentiations (the primality test pattern)
+  constexpr int kNumPows = 200000;
+  uint64_t modulus = 18446744073709551557ULL;
+  uint64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  Montgomery64 montgomery(modulus);
+  for (int i = 0; i < kNumPows; ++i) {
+    checksum += montgomery.Pow(i + 2, modulus - 1);
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNumPows; ++i) {
+    checksum -= NaivePowMod(i + 2, modulus - 1, modulus);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Montgomery: " << std::chrono::duration<double>(mid - start).count() << " s, "
+            << "128-bit divide: " << std::chrono::duration<double>(end - mid).count()
+            << " s (checksum " << checksum << ")" << std::endl;
+
   return 0;
 }
@@ -0,0 +1,200 @@
+#ifndef MATRIX_POWER_HPP
+#define MATRIX_POWER_HPP
+
+#include <array>
+#include <cstdint>
+#include <numeric> // std::iota
+#include <stdexcept>
+#include <type_traits>
+#include <utility> // std::move
+#include <vector>
+
+#include "int_power.hpp"
+
+// Fixed-size row-major N x N matrix. Multiplies use the i-k-j loop order so the innermost loop
+// runs over contiguous rows of both the output and the right operand, which the compiler
+// vectorizes.
+template <typename T, size_t N>
+class Matrix {
+ public:
+  constexpr Matrix() : data_{} {}
+
+  static constexpr Matrix Identity() {
+    Matrix result;
+    for (size_t i = 0; i < N; ++i) {
+      result(i, i) = 1;
+    }
+    return result;
+  }
+
+  constexpr T& operator()(size_t row, size_t col) { return data_[row * N + col]; }
+  constexpr const T& operator()(size_t row, size_t col) const { return data_[row * N + col]; }
+
+  constexpr T* Row(size_t row) { return data_.data() + row * N; }
+  constexpr const T* Row(size_t row) const { return data_.data() + row * N; }
+
+  friend constexpr Matrix operator*(const Matrix& left, const Matrix& right) {
+    Matrix result;
+    for (size_t i = 0; i < N; ++i) {
+      T* result_row = result.Row(i);
+      for (size_t k = 0; k < N; ++k) {
+        T left_ik = left(i, k);
+        const T* right_row = right.Row(k);
+        for (size_t j = 0; j < N; ++j) {
+          result_row[j] += left_ik * right_row[j];
+        }
+      }
+    }
+    return result;
+  }
+
+  // Matrix times column vector
+  friend constexpr std::array<T, N> operator*(const Matrix& matrix, const std::array<T, N>& vec) {
+    std::array<T, N> result{};
+    for (size_t i = 0; i < N; ++i) {
+      const T* row = matrix.Row(i);
+      for (size_t j = 0; j < N; ++j) {
+        result[i] += row[j] * vec[j];
+      }
+    }
+    return result;
+  }
+
+  friend constexpr bool operator==(const Matrix& left, const Matrix& right) {
+    for (size_t i = 0; i < N * N; ++i) {
+      if (!(left.data_[i] == right.data_[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::array<T, N * N> data_;
+};
+
+// (left * right) mod modulus for matrices with entries already reduced mod modulus.
+// Row sums are accumulated in 128 bits and reduced once per entry, which is exact while
+// N * (modulus - 1)^2 < 2^128 (any modulus below 2^60 with N <= 256); larger moduli reduce every
+// product instead.
+template <size_t N>
+Matrix<uint64_t, N> MultiplyMod(const Matrix<uint64_t, N>& left, const Matrix<uint64_t, N>& right,
+                                uint64_t modulus) {
+  Matrix<uint64_t, N> result;
+  bool reduce_each_product = modulus >= (1ULL << 60) || N > 256;
+  for (size_t i = 0; i < N; ++i) {
+    unsigned __int128 sums[N] = {};
+    for (size_t k = 0; k < N; ++k) {
+      uint64_t left_ik = left(i, k);
+      const uint64_t* right_row = right.Row(k);
+      for (size_t j = 0; j < N; ++j) {
+        sums[j] += static_cast<unsigned __int128>(left_ik) * right_row[j];
+        if (reduce_each_product) {
+          sums[j] %= modulus;
+        }
+      }
+    }
+    for (size_t j = 0; j < N; ++j) {
+      result(i, j) = static_cast<uint64_t>(sums[j] % modulus);
+    }
+  }
+  return result;
+}
+
+// matrix^exponent mod modulus
+template <size_t N, typename ExpType>
+Matrix<uint64_t, N> MatrixPowerMod(const Matrix<uint64_t, N>& matrix, ExpType exponent,
+                                   uint64_t modulus) {
+  Matrix<uint64_t, N> reduced;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      reduced(i, j) = matrix(i, j) % modulus;
+    }
+  }
+  Matrix<uint64_t, N> identity = Matrix<uint64_t, N>::Identity();
+  if (modulus == 1) {
+    identity = Matrix<uint64_t, N>();
+  }
+  return Power(reduced, exponent, [modulus](const auto& left, const auto& right) {
+    return MultiplyMod(left, right, modulus);
+  }, identity);
+}
+
+// matrix^exponent with plain (wrapping for unsigned, floating for float) arithmetic
+template <typename T, size_t N, typename ExpType>
+constexpr Matrix<T, N> MatrixPower(const Matrix<T, N>& matrix, ExpType exponent) {
+  return Power(matrix, exponent, [](const Matrix<T, N>& left, const Matrix<T, N>& right) {
+    return left * right;
+  }, Matrix<T, N>::Identity());
+}
+
+// Permutation of {0, ..., n - 1}: element i is sent to position Map()[i]
+class Permutation {
+ public:
+  Permutation() = default;
+
+  explicit Permutation(std::vector<uint32_t> mapping) : mapping_(std::move(mapping)) {}
+
+  static Permutation Identity(size_t size) {
+    std::vector<uint32_t> mapping(size);
+    std::iota(mapping.begin(), mapping.end(), 0);
+    return Permutation(std::move(mapping));
+  }
+
+  size_t Size() const { return mapping_.size(); }
+  uint32_t operator[](size_t i) const { return mapping_[i]; }
+  const std::vector<uint32_t>& Map() const { return mapping_; }
+
+  // Applies first, then second
+  friend Permutation Compose(const Permutation& first, const Permutation& second) {
+    if (first.Size() != second.Size()) {
+      throw std::invalid_argument("Compose: permutations of different sizes");
+    }
+    std::vector<uint32_t> mapping(first.Size());
+    for (size_t i = 0; i < mapping.size(); ++i) {
+      mapping[i] = second.mapping_[first.mapping_[i]];
+    }
+    return Permutation(std::move(mapping));
+  }
+
+  friend bool operator==(const Permutation& left, const Permutation& right) {
+    return left.mapping_ == right.mapping_;
+  }
+
+ private:
+  std::vector<uint32_t> mapping_;
+};
+
+// permutation applied exponent times
+template <typename ExpType>
+Permutation PermutationPower(const Permutation& permutation, ExpType exponent) {
+  return Power(permutation, exponent, [](const Permutation& first, const Permutation& second) {
+    return Compose(first, second);
+  }, Permutation::Identity(permutation.Size()));
+}
+
+// x -> scale * x + offset
+template <typename T>
+struct AffineTransform {
+  T scale = 1;
+  T offset = 0;
+
+  constexpr T operator()(T x) const { return scale * x + offset; }
+
+  // Applies first, then second
+  friend constexpr AffineTransform Compose(const AffineTransform& first,
+                                           const AffineTransform& second) {
+    return AffineTransform{second.scale * first.scale, second.scale * first.offset + second.offset};
+  }
+};
+
+// transform applied exponent times
+template <typename T, typename ExpType>
+constexpr AffineTransform<T> AffinePower(const AffineTransform<T>& transform, ExpType exponent) {
+  return Power(transform, exponent, [](const AffineTransform<T>& first,
+                                       const AffineTransform<T>& second) {
+    return Compose(first, second);
+  }, AffineTransform<T>());
+}
+
+#endif  // MATRIX_POWER_HPP
@@ -0,0 +1,98 @@
+#include <algorithm> // std::shuffle
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "matrix_power.hpp"
+
+// F(n) mod modulus by iterating, as a reference
+uint64_t FibonacciIterative(uint64_t n, uint64_t modulus) {
+  uint64_t a = 0;
+  uint64_t b = 1 % modulus;
+  for (uint64_t i = 0; i < n; ++i) {
+    uint64_t next = (a + b) % modulus;
+    a = b;
+    b = next;
+  }
+  return a;
+}
+
+uint64_t FibonacciMatrix(uint64_t n, uint64_t modulus) {
+  Matrix<uint64_t, 2> step;
+  step(0, 0) = 1;
+  step(0, 1) = 1;
+  step(1, 0) = 1;
+  return MatrixPowerMod(step, n, modulus)(0, 1);
+}
+
+int main() {
+  constexpr uint64_t kModulus = 1000000007;
+  int num_failures = 0;
+  for (uint64_t n = 0; n < 2000; ++n) {
+    num_failures += FibonacciMatrix(n, kModulus) != FibonacciIterative(n, kModulus);
+  }
+  std::cout << "Fibonacci matrix vs iterative: " << num_failures << " failures" << std::endl;
+  std::cout << "F(10^18) mod 10^9 + 7 = " << FibonacciMatrix(1000000000000000000ULL, kModulus)
+            << std::endl;
+  std::cout << "F(90) mod 2^64 - 59 = " << FibonacciMatrix(90, 18446744073709551557ULL)
+            << " (expected 2880067194370816120)" << std::endl;
+
+  // Tribonacci-like 4-term recurrence: jump 10^18 steps in ~60 4x4 products
+  Matrix<uint64_t, 4> step;
+  for (size_t j = 0; j < 4; ++j) {
+    step(0, j) = j + 1;
+  }
+  for (size_t i = 1; i < 4; ++i) {
+    step(i, i - 1) = 1;
+  }
+  auto start = std::chrono::steady_clock::now();
+  Matrix<uint64_t, 4> jump = MatrixPowerMod(step, 1000000000000000000ULL, kModulus);
+  auto end = std::chrono::steady_clock::now();
+  std::array<uint64_t, 4> state = jump * std::array<uint64_t, 4>{1, 0, 0, 0};
+  std::cout << "4-term recurrence after 10^18 steps: " << state[0] % kModulus << " ("
+            << std::chrono::duration<double, std::micro>(end - start).count() << " us)"
+            << std::endl;
+
+  // Wrapping arithmetic and floats work through the same Power
+  Matrix<double, 2> rotation;
+  rotation(0, 0) = 0;
+  rotation(0, 1) = -1;
+  rotation(1, 0) = 1;
+  Matrix<double, 2> full_turn = MatrixPower(rotation, 4);
+  std::cout << "Rotation by 90 degrees 4 times is identity: "
+            << (full_turn == Matrix<double, 2>::Identity() ? "yes" : "no") << std::endl;
+  std::cout << std::endl;
+
+  // Permutations: compare with applying the permutation step by step
+  std::mt19937 rng(3);
+  std::vector<uint32_t> mapping(10);
+  std::iota(mapping.begin(), mapping.end(), 0);
+  std::shuffle(mapping.begin(), mapping.end(), rng);
+  Permutation shuffle(mapping);
+  Permutation repeated = Permutation::Identity(10);
+  for (int i = 0; i < 1000; ++i) {
+    repeated = Compose(repeated, shuffle);
+  }
+  std::cout << "Permutation^1000 matches repeated composition: "
+            << (PermutationPower(shuffle, 1000) == repeated ? "yes" : "no") << std::endl;
+  Permutation big_jump = PermutationPower(shuffle, 1000000000000000003ULL);
+  std::cout << "Permutation^(10^18 + 3): ";
+  for (uint32_t value : big_jump.Map()) {
+    std::cout << value << " ";
+  }
+  std::cout << std::endl;
+
+  // Affine transforms: x -> 3x + 1 applied 20 times
+  AffineTransform<int64_t> transform{3, 1};
+  int64_t x = 5;
+  for (int i = 0; i < 20; ++i) {
+    x = transform(x);
+  }
+  std::cout << "Affine^20(5) = " << AffinePower(transform, 20)(5) << " (expected " << x << ")"
+            << std::endl;
+  static_assert(AffinePower(AffineTransform<int64_t>{2, 0}, 10)(1) == 1024, "constexpr Power");
+
+  return 0;
+}
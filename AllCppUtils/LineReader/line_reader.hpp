@@ -0,0 +1,281 @@
+#ifndef LINE_READER_HPP
+#define LINE_READER_HPP
+
+#include <fcntl.h> // open, posix_fadvise
+#include <sys/mman.h> // mmap, madvise
+#include <sys/stat.h> // fstat
+#include <unistd.h> // read, close
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring> // std::memchr, std::memmove
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+
+// Reads a file line by line without copying: regular files are mmap'd and lines are returned as
+// string_views into the mapped pages; pipes, sockets and ttys fall back to large streaming read()s.
+// Returned lines never include the trailing '\n' and are valid until the next ReadLine() call
+// (streaming mode) or until the LineReader is destroyed (mapped and in-memory modes).
+class LineReader {
+ public:
+  static constexpr size_t kStreamBufferSize = 4 << 20;
+  static constexpr size_t kReadaheadBytes = 64 << 20;
+
+  // Opens and maps the file, throws std::system_error on failure
+  explicit LineReader(const std::string& filename) : owns_fd_(true) {
+    fd_ = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "open " + filename);
+    }
+    Init();
+  }
+
+  explicit LineReader(const char* filename) : LineReader(std::string(filename)) {}
+
+  explicit LineReader(std::string_view filename) : LineReader(std::string(filename)) {}
+
+  // Reads from an already open descriptor (e.g. STDIN_FILENO), which is not closed on destruction
+  explicit LineReader(int fd) : fd_(fd), owns_fd_(false) {
+    Init();
+  }
+
+  // Iterates over the lines of an in-memory buffer, e.g. one chunk from SplitAtNewlines().
+  // A named factory, since every string-typed constructor argument is a filename.
+  static LineReader FromBuffer(std::string_view data) {
+    return LineReader(BufferTag(), data);
+  }
+
+  LineReader(const LineReader&) = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  ~LineReader() {
+    if (map_ != nullptr) {
+      munmap(map_, map_size_);
+    }
+    if (owns_fd_ && fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // Returns false once all lines have been consumed
+  bool ReadLine(std::string_view& line) {
+    return streaming_ ? ReadStreamingLine(line) : ReadMappedLine(line);
+  }
+
+  // True when the whole input is addressable at once (mapped file or in-memory buffer)
+  bool IsMapped() const { return !streaming_; }
+
+  // Entire input, only available when IsMapped()
+  std::string_view Data() const { return data_; }
+
+ private:
+  struct BufferTag {};
+
+  LineReader(BufferTag, std::string_view data) : data_(data) {}
+
+  int fd_ = -1;
+  bool owns_fd_ = false;
+  bool streaming_ = false;
+  bool eof_ = false;
+  void* map_ = nullptr;
+  size_t map_size_ = 0;
+  std::string_view data_;
+  size_t position_ = 0;
+  size_t advised_until_ = 0;
+  std::vector<char> buffer_;
+  size_t buffer_begin_ = 0;
+  size_t buffer_end_ = 0;
+
+  void Init() {
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+      if (file_stat.st_size == 0) {
+        return;  // Empty file, nothing to map
+      }
+      map_size_ = static_cast<size_t>(file_stat.st_size);
+      map_ = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (map_ != MAP_FAILED) {
+        madvise(map_, map_size_, MADV_SEQUENTIAL);
+        data_ = std::string_view(static_cast<const char*>(map_), map_size_);
+        AdviseReadahead();
+        return;
+      }
+      map_ = nullptr;
+      map_size_ = 0;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    streaming_ = true;
+    buffer_.resize(kStreamBufferSize);
+  }
+
+  // Keeps the kernel prefetching a large window ahead of the current position
+  void AdviseReadahead() {
+    if (map_ == nullptr || advised_until_ >= map_size_ ||
+        position_ + kReadaheadBytes / 2 < advised_until_) {
+      return;
+    }
+    const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = advised_until_ & ~(kPageSize - 1);
+    size_t end = std::min(map_size_, position_ + kReadaheadBytes);
+    madvise(static_cast<char*>(map_) + begin, end - begin, MADV_WILLNEED);
+    advised_until_ = end;
+  }
+
+  bool ReadMappedLine(std::string_view& line) {
+    if (position_ >= data_.size()) {
+      return false;
+    }
+    const char* begin = data_.data() + position_;
+    size_t remaining = data_.size() - position_;
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+    size_t length = newline ? static_cast<size_t>(newline - begin) : remaining;
+    line = std::string_view(begin, length);
+    position_ += newline ? length + 1 : length;
+    AdviseReadahead();
+    return true;
+  }
+
+  bool ReadStreamingLine(std::string_view& line) {
+    size_t scan_from = buffer_begin_;
+    while (true) {
+      const char* newline = static_cast<const char*>(
+          std::memchr(buffer_.data() + scan_from, '\n', buffer_end_ - scan_from));
+      if (newline != nullptr) {
+        size_t length = static_cast<size_t>(newline - (buffer_.data() + buffer_begin_));
+        line = std::string_view(buffer_.data() + buffer_begin_, length);
+        buffer_begin_ += length + 1;
+        return true;
+      }
+      if (eof_) {
+        if (buffer_begin_ == buffer_end_) {
+          return false;
+        }
+        // Final line without a trailing newline
+        line = std::string_view(buffer_.data() + buffer_begin_, buffer_end_ - buffer_begin_);
+        buffer_begin_ = buffer_end_;
+        return true;
+      }
+      // Line straddles the end of the buffer: keep the partial line and read more after it
+      scan_from = buffer_end_ - buffer_begin_;
+      Refill();
+    }
+  }
+
+  void Refill() {
+    size_t pending = buffer_end_ - buffer_begin_;
+    if (buffer_begin_ > 0) {
+      std::memmove(buffer_.data(), buffer_.data() + buffer_begin_, pending);
+      buffer_begin_ = 0;
+      buffer_end_ = pending;
+    }
+    if (buffer_end_ == buffer_.size()) {
+      buffer_.resize(buffer_.size() * 2);  // Single line longer than the buffer
+    }
+    ssize_t bytes_read;
+    do {
+      bytes_read = read(fd_, buffer_.data() + buffer_end_, buffer_.size() - buffer_end_);
+    } while (bytes_read < 0 && errno == EINTR);
+    if (bytes_read < 0) {
+      throw std::system_error(errno, std::generic_category(), "read");
+    }
+    if (bytes_read == 0) {
+      eof_ = true;
+    }
+    buffer_end_ += static_cast<size_t>(bytes_read);
+  }
+};
+
+// Splits a line into fields without allocating once the output vector has grown to the widest
+// line, consecutive delimiters are collapsed unless retain_empty is set (same as SplitString)
+inline void SplitFields(std::string_view line, char delim, std::vector<std::string_view>& fields,
+                        bool retain_empty = false) {
+  fields.clear();
+  size_t start_i = 0;
+  while (true) {
+    const char* found = (start_i < line.size()) ? static_cast<const char*>(
+        std::memchr(line.data() + start_i, delim, line.size() - start_i)) : nullptr;
+    size_t found_i = found ? static_cast<size_t>(found - line.data()) : line.size();
+    if (found_i > start_i || retain_empty) {
+      fields.push_back(line.substr(start_i, found_i - start_i));
+    }
+    if (found == nullptr) {
+      return;
+    }
+    start_i = found_i + 1;
+  }
+}
+
+// Reads delimiter-separated records, fields are string_views into the LineReader's storage
+class FieldReader {
+ public:
+  FieldReader(LineReader& line_reader, char delim, bool retain_empty = false) :
+      line_reader_(line_reader), delim_(delim), retain_empty_(retain_empty) {}
+
+  // Returns false once all lines have been consumed
+  bool ReadFields(std::vector<std::string_view>& fields) {
+    std::string_view line;
+    if (!line_reader_.ReadLine(line)) {
+      return false;
+    }
+    SplitFields(line, delim_, fields, retain_empty_);
+    return true;
+  }
+
+ private:
+  LineReader& line_reader_;
+  char delim_;
+  bool retain_empty_;
+};
+
+// Splits data into at most num_chunks pieces of roughly equal size, each ending just after a
+// newline (or at the end of data), so no line is shared between two chunks
+inline std::vector<std::string_view> SplitAtNewlines(std::string_view data, size_t num_chunks) {
+  std::vector<std::string_view> chunks;
+  num_chunks = std::max<size_t>(num_chunks, 1);
+  size_t target_size = data.size() / num_chunks + 1;
+  size_t start_i = 0;
+  while (start_i < data.size()) {
+    size_t end_i = std::min(data.size(), start_i + target_size);
+    if (end_i < data.size()) {
+      size_t newline_i = data.find('\n', end_i - 1);
+      end_i = (newline_i == std::string_view::npos) ? data.size() : newline_i + 1;
+    }
+    chunks.push_back(data.substr(start_i, end_i - start_i));
+    start_i = end_i;
+  }
+  return chunks;
+}
+
+// Calls fn(chunk_index, line) for every line of the file, parsing newline-aligned chunks of the
+// mapped file as num_threads tasks on the shared thread pool. Lines within a chunk are visited in
+// order; unmappable inputs are read serially as chunk 0.
+template <typename LineFunction>
+void ParallelForEachLine(const std::string& filename, LineFunction fn, size_t num_threads = 0) {
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  LineReader file_reader(filename);
+  std::string_view line;
+  if (!file_reader.IsMapped() || num_threads == 1) {
+    while (file_reader.ReadLine(line)) {
+      fn(size_t{0}, line);
+    }
+    return;
+  }
+  std::vector<std::string_view> chunks = SplitAtNewlines(file_reader.Data(), num_threads);
+  thread_pool::ParallelFor(0, chunks.size(), 1, [&fn, &chunks](size_t chunk_i) {
+    LineReader chunk_reader = LineReader::FromBuffer(chunks[chunk_i]);
+    std::string_view chunk_line;
+    while (chunk_reader.ReadLine(chunk_line)) {
+      fn(chunk_i, chunk_line);
+    }
+  });
+}
+
+#endif  // LINE_READER_HPP
@@ -0,0 +1,70 @@
+#include <unistd.h> // STDIN_FILENO
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "line_reader.hpp"
+
+void PrintFields(const std::vector<std::string_view>& fields) {
+  std::cout << "[";
+  for (size_t i = 0; i < fields.size(); ++i) {
+    std::cout << "\"" << fields[i] << "\"";
+    if (i + 1 < fields.size()) {
+      std::cout << ", ";
+    }
+  }
+  std::cout << "]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  // With no arguments, demonstrate on a small temporary file
+  std::string filename = (argc > 1) ? argv[1] : "line_reader_demo.tsv";
+  if (argc <= 1) {
+    std::ofstream demo_file(filename);
+    demo_file << "name\tcount\tscore\n";
+    demo_file << "alpha\t12\t0.5\n";
+    demo_file << "beta\t\t1.25\n";
+    demo_file << "gamma\t7\t3.0";  // No trailing newline
+  }
+
+  std::cout << "-- Lines:" << std::endl;
+  LineReader line_reader(filename);
+  std::string_view line;
+  while (line_reader.ReadLine(line)) {
+    std::cout << "[" << line << "]" << std::endl;
+  }
+
+  std::cout << std::endl << "-- Fields (retain_empty = true):" << std::endl;
+  LineReader field_line_reader(filename);
+  FieldReader field_reader(field_line_reader, '\t', true);
+  std::vector<std::string_view> fields;
+  while (field_reader.ReadFields(fields)) {
+    PrintFields(fields);
+  }
+
+  std::cout << std::endl << "-- Parallel line count:" << std::endl;
+  std::atomic<size_t> num_lines(0);
+  ParallelForEachLine(filename, [&num_lines](size_t, std::string_view) { ++num_lines; }, 4);
+  std::cout << num_lines << " lines" << std::endl;
+
+  std::cout << std::endl << "-- Newline-aligned chunks:" << std::endl;
+  std::string text("one\ntwo\nthree\nfour\nfive\n");
+  for (std::string_view chunk : SplitAtNewlines(text, 3)) {
+    std::cout << "[" << chunk.substr(0, chunk.size() - 1) << "]" << std::endl;
+  }
+
+  std::cout << std::endl << "-- In-memory buffer:" << std::endl;
+  LineReader buffer_reader = LineReader::FromBuffer(text);
+  while (buffer_reader.ReadLine(line)) {
+    std::cout << "[" << line << "]" << std::endl;
+  }
+
+  if (argc <= 1) {
+    std::remove(filename.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "number_format.hpp"
+
+template <typename NumberType>
+void PrintAllPolicies(NumberType value) {
+  using namespace number_format;
+  std::cout << value << ":"
+            << " HumanReadable=" << Format(value, HumanReadable{})
+            << " Si=" << Format(value, Si{})
+            << " Iec=" << Format(value, Iec{})
+            << " Grouped=" << Format(value, Grouped{})
+            << " Scientific=" << Format(value, Scientific{})
+            << " SigFigs=" << Format(value, SigFigs{}) << std::endl;
+}
+
+int main() {
+  PrintAllPolicies(0);
+  PrintAllPolicies(999);
+  PrintAllPolicies(1536);
+  PrintAllPolicies(-1345365);
+  PrintAllPolicies(999500);
+  PrintAllPolicies(6147724571147LL);
+  PrintAllPolicies(-9223372036854775807LL - 1);
+  PrintAllPolicies(18446744073709551615ULL);
+  std::cout << std::endl;
+
+  PrintAllPolicies(3.14159);
+  PrintAllPolicies(-0.000123456);
+  PrintAllPolicies(1234567.891);
+  PrintAllPolicies(2.5e30);
+  std::cout << std::endl;
+
+  char buffer[number_format::kMaxFormattedLength];
+  std::cout << "Iec 1048575 (4 sig figs): "
+            << number_format::FormatTo(buffer, 1048575, number_format::Iec{4}) << std::endl;
+  std::cout << "Grouped 1234.5 (' separator, precision 2): "
+            << number_format::FormatTo(buffer, 1234.5, number_format::Grouped{'\'', 2})
+            << std::endl;
+  std::cout << "Grouped tiny values: " << number_format::Format(1e-50, number_format::Grouped{})
+            << " " << number_format::Format(5e-324, number_format::Grouped{}) << " "
+            << number_format::Format(-1.5e-45f, number_format::Grouped{}) << std::endl;
+  std::cout << "Iec rollover: " << number_format::Format(1023.9 * 1024, number_format::Iec{})
+            << " " << number_format::Format(1000 * 1024, number_format::Iec{}) << " "
+            << number_format::Format(1048575, number_format::Iec{4}) << std::endl;
+  std::cout << std::endl;
+
+  // Aligned table from a formatted column
+  std::vector<int64_t> sizes{512, 4096, 1500000, 73400320, 5368709120LL};
+  number_format::FormattedColumn column = number_format::FormatColumn(sizes, number_format::Iec{});
+  std::string table;
+  for (size_t i = 0; i < column.size(); ++i) {
+    table += "| ";
+    column.AppendPadded(table, i);
+    table += " |\n";
+  }
+  std::cout << table << std::endl;
+
+  // Throughput for a large column
+  constexpr size_t kNumValues = 10000000;
+  std::mt19937_64 rng(42);
+  std::vector<int64_t> values(kNumValues);
+  for (int64_t& value : values) {
+    value = static_cast<int64_t>(rng() >> (rng() % 60));
+  }
+  auto start = std::chrono::steady_clock::now();
+  column = number_format::FormatColumn(values, number_format::HumanReadable{});
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "FormatColumn: " << kNumValues << " values, " << column.arena.size() << " bytes in "
+            << seconds << " s (" << column.arena.size() / seconds / 1e6 << " MB/s), width "
+            << column.common_width << std::endl;
+
+  return 0;
+}
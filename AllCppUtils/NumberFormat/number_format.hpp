@@ -0,0 +1,503 @@
+#ifndef NUMBER_FORMAT_HPP
+#define NUMBER_FORMAT_HPP
+
+#include <algorithm> // std::min, std::max
+#include <charconv> // std::to_chars
+#include <cmath> // std::isfinite, std::signbit
+#include <cstdint>
+#include <cstring> // std::memcpy, std::memset
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../IntPower/int_power.hpp"
+
+// One formatting engine for readable numbers. The style is a policy object:
+//   HumanReadable  1.94M, 5.33B, 18.4E   (K M B T P E, values below 1000 exact)
+//   Si             1.94M, 5.33G, 12.0k   (k M G T P E)
+//   Iec            512B, 1.50KiB, 3.00GiB
+//   Grouped        1,234,567 / 1,234.57
+//   Scientific     1.235e+06
+//   SigFigs        1230000, 0.00123  (fixed notation, N significant figures)
+// FormatTo writes into a stack buffer of kMaxFormattedLength chars, FormatColumn formats a whole
+// column into one contiguous arena.
+namespace number_format {
+
+constexpr size_t kMaxFormattedLength = 64;
+
+// The suffixed styles can also be tuned towards FormatNumber's "1.3 M": with max_decimals >= 0
+// the integer part of the scaled value is always written whole and sig_figs only limits the
+// digits after the point
+struct HumanReadable {
+  int sig_figs = 3;
+  int max_decimals = -1;  // -1 = as many as sig_figs allows
+  bool truncate = false;  // Cut digits instead of rounding half up (integers only)
+  bool trim_zeros = false;  // Drop trailing zeros after the point, and the point itself
+  std::string_view suffix_separator = "";  // Between the number and the suffix, a few chars at most
+};
+
+struct Si {
+  int sig_figs = 3;
+  int max_decimals = -1;
+  bool truncate = false;
+  bool trim_zeros = false;
+  std::string_view suffix_separator = "";
+};
+
+struct Iec {
+  int sig_figs = 3;
+};
+
+struct Grouped {
+  char separator = ',';
+  int precision = -1;  // Digits after the decimal point for floats, -1 = shortest round-trip
+};
+
+struct Scientific {
+  int precision = 3;
+};
+
+struct SigFigs {
+  int sig_figs = 3;
+};
+
+namespace internal {
+
+constexpr auto kPowersOfTen = MakePowerTable<uint64_t, 10>();
+
+// Exponents beyond this are written in scientific notation so output fits the buffer
+constexpr int kMaxFixedExponent = 20;
+
+inline int NumDigits(uint64_t value) {
+  // floor(log10(2^bits)) from the bit width, then one compare to correct it
+  int num_bits = 64 - __builtin_clzll(value | 1);
+  int num_digits = (num_bits * 1233) >> 12;
+  return num_digits + ((value | 1) >= kPowersOfTen[num_digits] ? 1 : 0);
+}
+
+inline int ClampSigFigs(int sig_figs) {
+  return std::min(std::max(sig_figs, 1), 19);
+}
+
+// Splits a number into its sign and magnitude, correct for the most negative integer
+template <typename IntType>
+uint64_t IntMagnitude(IntType value, bool& negative) {
+  uint64_t magnitude = static_cast<uint64_t>(value);
+  negative = value < 0;
+  return negative ? 0 - magnitude : magnitude;
+}
+
+// Rounds magnitude half up (or truncates) to sig_figs significant digits using integer
+// arithmetic only. Writes exactly sig_figs digit chars and returns the decimal exponent of the
+// leading digit.
+inline int IntSigFigDigits(uint64_t magnitude, int sig_figs, char* digits, bool truncate = false) {
+  if (magnitude == 0) {
+    std::memset(digits, '0', sig_figs);
+    return 0;
+  }
+  int num_digits = NumDigits(magnitude);
+  uint64_t mantissa;
+  if (num_digits > sig_figs) {
+    uint64_t divisor = kPowersOfTen[num_digits - sig_figs];
+    mantissa = magnitude / divisor;
+    uint64_t remainder = magnitude % divisor;
+    if (!truncate && remainder >= divisor - remainder) {
+      ++mantissa;
+    }
+    if (mantissa == kPowersOfTen[sig_figs]) {
+      // Rounded up to the next power of ten, e.g. 999.9K -> 1.00M
+      mantissa /= 10;
+      ++num_digits;
+    }
+  } else {
+    mantissa = magnitude * kPowersOfTen[sig_figs - num_digits];
+  }
+  // mantissa has exactly sig_figs digits, write them back to front
+  for (int i = sig_figs - 1; i >= 0; --i) {
+    digits[i] = static_cast<char>('0' + mantissa % 10);
+    mantissa /= 10;
+  }
+  return num_digits - 1;
+}
+
+// Same as IntSigFigDigits for a finite non-negative float, correctly rounded by std::to_chars
+template <typename FloatType>
+int FloatSigFigDigits(FloatType magnitude, int sig_figs, char* digits) {
+  char scientific[kMaxFormattedLength];
+  char* end = std::to_chars(scientific, scientific + kMaxFormattedLength, magnitude,
+                            std::chars_format::scientific, sig_figs - 1).ptr;
+  // Layout is d[.ddd]e(+|-)XX
+  digits[0] = scientific[0];
+  if (sig_figs > 1) {
+    std::memcpy(digits + 1, scientific + 2, sig_figs - 1);
+  }
+  const char* exponent_chars = scientific + (sig_figs > 1 ? sig_figs + 2 : 2);
+  int exponent = 0;
+  std::from_chars(exponent_chars + (exponent_chars[0] == '+' ? 1 : 0), end, exponent);
+  return exponent;
+}
+
+// Writes sig_figs already rounded digits with the decimal point after digits_before_decimal of
+// them, padding with zeros on either side as needed ("452": 1 -> 4.52, 5 -> 45200, -1 -> 0.0452)
+inline char* WriteDecimal(char* out, const char* digits, int sig_figs, int digits_before_decimal) {
+  // Only a handful of chars: plain loops beat out-of-line memcpy calls here
+  if (digits_before_decimal <= 0) {
+    *out++ = '0';
+    *out++ = '.';
+    for (int i = digits_before_decimal; i < 0; ++i) {
+      *out++ = '0';
+    }
+    digits_before_decimal = -1;  // Point already written
+  }
+  for (int i = 0; i < sig_figs; ++i) {
+    if (i == digits_before_decimal) {
+      *out++ = '.';
+    }
+    *out++ = digits[i];
+  }
+  for (int i = sig_figs; i < digits_before_decimal; ++i) {
+    *out++ = '0';
+  }
+  return out;
+}
+
+inline char* WriteString(char* out, std::string_view s) {
+  for (char ch : s) {
+    *out++ = ch;
+  }
+  return out;
+}
+
+template <typename FloatType>
+char* WriteNonFinite(char* out, FloatType value) {
+  if (std::isnan(value)) {
+    return WriteString(out, "nan");
+  }
+  return WriteString(out, value < 0 ? "-inf" : "inf");
+}
+
+// Removes trailing zeros after the decimal point in [begin, end), and the point if nothing is
+// left after it
+inline char* TrimZeros(char* begin, char* end) {
+  if (std::find(begin, end, '.') == end) {
+    return end;
+  }
+  while (end[-1] == '0') {
+    --end;
+  }
+  return end[-1] == '.' ? end - 1 : end;
+}
+
+// Digits to write for a value whose leading digit has this exponent: the whole integer part of
+// the value scaled by 1000^k, then up to max_decimals more while within sig_figs
+inline int ScaledDigits(int exponent, int sig_figs, int max_decimals) {
+  if (max_decimals < 0 || exponent < 0) {
+    return sig_figs;
+  }
+  int integer_digits = exponent % 3 + 1;
+  int decimals = std::min(max_decimals, std::max(0, sig_figs - integer_digits));
+  return std::min(19, integer_digits + decimals);
+}
+
+// Writes digits scaled by the largest power of 1000 with a suffix in suffixes (index i is the
+// suffix for 1000^i), falling back to scientific notation past the last suffix
+template <typename Policy>
+char* WriteWithSuffix(char* out, const char* digits, int sig_figs, int exponent,
+                      const std::string_view* suffixes, int num_suffixes, const Policy& policy) {
+  int suffix_index = (exponent < 0) ? 0 : exponent / 3;
+  char* number_begin = out;
+  if (suffix_index >= num_suffixes) {
+    out = WriteDecimal(out, digits, sig_figs, 1);
+    if (policy.trim_zeros) {
+      out = TrimZeros(number_begin, out);
+    }
+    *out++ = 'e';
+    *out++ = '+';
+    return std::to_chars(out, out + 8, exponent).ptr;
+  }
+  out = WriteDecimal(out, digits, sig_figs, exponent - 3 * suffix_index + 1);
+  if (policy.trim_zeros) {
+    out = TrimZeros(number_begin, out);
+  }
+  if (!suffixes[suffix_index].empty()) {
+    out = WriteString(out, policy.suffix_separator);
+  }
+  return WriteString(out, suffixes[suffix_index]);
+}
+
+template <typename NumberType, typename Policy>
+char* WriteSuffixed(char* out, NumberType value, const Policy& policy, bool exact_below_1000,
+                    const std::string_view* suffixes, int num_suffixes) {
+  int sig_figs = ClampSigFigs(policy.sig_figs);
+  char digits[20];
+  int exponent;
+  if constexpr (std::is_integral<NumberType>::value) {
+    bool negative;
+    uint64_t magnitude = IntMagnitude(value, negative);
+    if (negative) {
+      *out++ = '-';
+    }
+    if (exact_below_1000 && magnitude < 1000) {
+      return std::to_chars(out, out + 4, magnitude).ptr;
+    }
+    sig_figs = ScaledDigits(NumDigits(magnitude) - 1, sig_figs, policy.max_decimals);
+    exponent = IntSigFigDigits(magnitude, sig_figs, digits, policy.truncate);
+  } else {
+    if (!std::isfinite(value)) {
+      return WriteNonFinite(out, value);
+    }
+    if (std::signbit(value) && value != 0) {
+      *out++ = '-';
+    }
+    exponent = FloatSigFigDigits(std::fabs(value), sig_figs, digits);
+    if (exponent < -kMaxFixedExponent) {
+      return std::to_chars(out, out + kMaxFormattedLength - 1, std::fabs(value),
+                           std::chars_format::scientific, sig_figs - 1).ptr;
+    }
+    int scaled_digits = ScaledDigits(exponent, sig_figs, policy.max_decimals);
+    if (scaled_digits != sig_figs) {
+      sig_figs = scaled_digits;
+      exponent = FloatSigFigDigits(std::fabs(value), sig_figs, digits);
+    }
+  }
+  // Rounding up to the next power of ten (999.96K -> 1.000M) leaves zeros past max_decimals
+  sig_figs = std::min(sig_figs, ScaledDigits(exponent, sig_figs, policy.max_decimals));
+  return WriteWithSuffix(out, digits, sig_figs, exponent, suffixes, num_suffixes, policy);
+}
+
+// Inserts separator every 3 digits of the integer part starting at digits_begin, returns the new
+// end
+inline char* GroupThousands(char* digits_begin, char* end, char separator) {
+  char* digits_end = digits_begin;
+  while (digits_end < end && *digits_end >= '0' && *digits_end <= '9') {
+    ++digits_end;
+  }
+  size_t num_digits = digits_end - digits_begin;
+  size_t num_separators = (num_digits == 0) ? 0 : (num_digits - 1) / 3;
+  if (num_separators == 0) {
+    return end;
+  }
+  // Shift from the back so the move can be done in place
+  char* new_end = end + num_separators;
+  std::memmove(digits_end + num_separators, digits_end, end - digits_end);
+  char* write_ptr = digits_end + num_separators;
+  size_t count = 0;
+  for (char* read_ptr = digits_end; read_ptr != digits_begin;) {
+    *--write_ptr = *--read_ptr;
+    if (++count % 3 == 0 && read_ptr != digits_begin) {
+      *--write_ptr = separator;
+    }
+  }
+  return new_end;
+}
+
+}  // namespace internal
+
+// Policy implementations: each writes at most kMaxFormattedLength chars and returns the new end
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const HumanReadable& policy) {
+  static constexpr std::string_view kSuffixes[] = {"", "K", "M", "B", "T", "P", "E"};
+  return internal::WriteSuffixed(out, value, policy, true, kSuffixes, 7);
+}
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const Si& policy) {
+  static constexpr std::string_view kSuffixes[] = {"", "k", "M", "G", "T", "P", "E"};
+  return internal::WriteSuffixed(out, value, policy, true, kSuffixes, 7);
+}
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const Iec& policy) {
+  static constexpr std::string_view kSuffixes[] = {"B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB"};
+  int sig_figs = internal::ClampSigFigs(policy.sig_figs);
+  double magnitude;
+  if constexpr (std::is_integral<NumberType>::value) {
+    bool negative;
+    uint64_t int_magnitude = internal::IntMagnitude(value, negative);
+    if (negative) {
+      *out++ = '-';
+    }
+    if (int_magnitude < 1024) {
+      out = std::to_chars(out, out + 4, int_magnitude).ptr;
+      return internal::WriteString(out, kSuffixes[0]);
+    }
+    magnitude = static_cast<double>(int_magnitude);
+  } else {
+    if (!std::isfinite(value)) {
+      return internal::WriteNonFinite(out, value);
+    }
+    if (std::signbit(value) && value != 0) {
+      *out++ = '-';
+    }
+    magnitude = std::fabs(static_cast<double>(value));
+  }
+  int scale_index = 0;
+  while (scale_index + 1 < 7 && magnitude >= 1024.0) {
+    magnitude /= 1024.0;  // Exact, only the exponent changes
+    ++scale_index;
+  }
+  char digits[20];
+  int exponent = internal::FloatSigFigDigits(magnitude, sig_figs, digits);
+  if (scale_index + 1 < 7 && exponent >= 3) {
+    // The rounded value has 4 integer digits, show it in the next unit instead:
+    // 1023.9KiB -> 1.00MiB, 1000KiB -> 0.977MiB
+    magnitude /= 1024.0;
+    ++scale_index;
+    exponent = internal::FloatSigFigDigits(magnitude, sig_figs, digits);
+  }
+  if (exponent > 3 || exponent < -internal::kMaxFixedExponent) {
+    // Only reachable past the largest unit or far below one byte
+    out = std::to_chars(out, out + 32, magnitude, std::chars_format::scientific, sig_figs - 1).ptr;
+  } else {
+    out = internal::WriteDecimal(out, digits, sig_figs, exponent + 1);
+  }
+  return internal::WriteString(out, kSuffixes[scale_index]);
+}
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const Grouped& policy) {
+  if constexpr (std::is_integral<NumberType>::value) {
+    bool negative;
+    uint64_t magnitude = internal::IntMagnitude(value, negative);
+    if (negative) {
+      *out++ = '-';
+    }
+    char* digits_begin = out;
+    out = std::to_chars(out, out + 24, magnitude).ptr;
+    return internal::GroupThousands(digits_begin, out, policy.separator);
+  } else {
+    if (!std::isfinite(value) || std::fabs(value) >= 1e21) {
+      return std::to_chars(out, out + 32, value).ptr;  // Too long to group, keep it readable
+    }
+    char* begin = out;
+    if (std::signbit(value)) {
+      *out++ = '-';
+    }
+    char* digits_begin = out;
+    int precision = std::min(policy.precision, 16);
+    std::to_chars_result result = (precision < 0) ?
+        std::to_chars(out, out + 40, std::fabs(value), std::chars_format::fixed) :
+        std::to_chars(out, out + 40, std::fabs(value), std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+      // Shortest fixed form of a tiny value, e.g. 1e-50, is too long: use scientific
+      return std::to_chars(begin, begin + 32, value, std::chars_format::scientific).ptr;
+    }
+    out = result.ptr;
+    return internal::GroupThousands(digits_begin, out, policy.separator);
+  }
+}
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const Scientific& policy) {
+  int precision = std::min(std::max(policy.precision, 0), 40);
+  return std::to_chars(out, out + kMaxFormattedLength, static_cast<double>(value),
+                       std::chars_format::scientific, precision).ptr;
+}
+
+template <typename NumberType>
+char* Write(char* out, NumberType value, const SigFigs& policy) {
+  int sig_figs = internal::ClampSigFigs(policy.sig_figs);
+  char digits[20];
+  int exponent;
+  if constexpr (std::is_integral<NumberType>::value) {
+    bool negative;
+    uint64_t magnitude = internal::IntMagnitude(value, negative);
+    if (negative) {
+      *out++ = '-';
+    }
+    exponent = internal::IntSigFigDigits(magnitude, sig_figs, digits);
+  } else {
+    if (!std::isfinite(value)) {
+      return internal::WriteNonFinite(out, value);
+    }
+    if (std::signbit(value) && value != 0) {
+      *out++ = '-';
+    }
+    exponent = internal::FloatSigFigDigits(std::fabs(value), sig_figs, digits);
+    if (exponent > internal::kMaxFixedExponent || exponent < -internal::kMaxFixedExponent) {
+      return std::to_chars(out, out + 32, std::fabs(value), std::chars_format::scientific,
+                           sig_figs - 1).ptr;
+    }
+  }
+  return internal::WriteDecimal(out, digits, sig_figs, exponent + 1);
+}
+
+// Formats a single value into buffer and returns a view of the result
+template <typename NumberType, typename Policy, size_t N>
+std::string_view FormatTo(char (&buffer)[N], NumberType value, const Policy& policy) {
+  static_assert(std::is_arithmetic<NumberType>::value, "Arithmetic type required");
+  static_assert(N >= kMaxFormattedLength, "Buffer must hold kMaxFormattedLength chars");
+  char* end = Write(buffer, value, policy);
+  return std::string_view(buffer, end - buffer);
+}
+
+template <typename NumberType, typename Policy>
+std::string Format(NumberType value, const Policy& policy) {
+  char buffer[kMaxFormattedLength];
+  return std::string(FormatTo(buffer, value, policy));
+}
+
+// A formatted column: all strings live back to back in one arena, string i spans
+// [offsets[i], offsets[i + 1]). common_width is the longest string, for aligning tables.
+struct FormattedColumn {
+  std::vector<char> arena;
+  std::vector<size_t> offsets{0};
+  size_t common_width = 0;
+
+  size_t size() const { return offsets.size() - 1; }
+
+  std::string_view operator[](size_t i) const {
+    return std::string_view(arena.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  // Appends string i padded to common_width
+  void AppendPadded(std::string& output, size_t i, bool align_right = true) const {
+    std::string_view s = (*this)[i];
+    size_t padding = common_width - s.size();
+    if (align_right) {
+      output.append(padding, ' ');
+    }
+    output.append(s.data(), s.size());
+    if (!align_right) {
+      output.append(padding, ' ');
+    }
+  }
+};
+
+// Formats every value into one arena: a single growing allocation instead of one string per
+// value, and no per-value stream or locale
+template <typename NumberType, typename Policy>
+FormattedColumn FormatColumn(const NumberType* values, size_t num_values, const Policy& policy) {
+  static_assert(std::is_arithmetic<NumberType>::value, "Arithmetic type required");
+  FormattedColumn column;
+  column.offsets.resize(num_values + 1);
+  // Most formatted values are short, grow from a guess rather than the worst case
+  column.arena.resize(std::max<size_t>(num_values * 8, kMaxFormattedLength));
+  size_t used = 0;
+  size_t common_width = 0;
+  for (size_t i = 0; i < num_values; ++i) {
+    if (column.arena.size() - used < kMaxFormattedLength) {
+      column.arena.resize(column.arena.size() * 2);
+    }
+    char* begin = column.arena.data() + used;
+    char* end = Write(begin, values[i], policy);
+    size_t length = end - begin;
+    common_width = std::max(common_width, length);
+    used += length;
+    column.offsets[i + 1] = used;
+  }
+  column.arena.resize(used);
+  column.common_width = common_width;
+  return column;
+}
+
+template <typename NumberType, typename Policy>
+FormattedColumn FormatColumn(const std::vector<NumberType>& values, const Policy& policy) {
+  return FormatColumn(values.data(), values.size(), policy);
+}
+
+}  // namespace number_format
+
+#endif  // NUMBER_FORMAT_HPP
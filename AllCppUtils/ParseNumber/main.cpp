@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "parse_number.hpp"
+
+template <typename T>
+void TestParse(std::string_view s) {
+  std::optional<T> value = ParseNumber<T>(s);
+  std::cout << "\"" << s << "\" -> ";
+  if (value) {
+    std::cout << +*value << std::endl;
+  } else {
+    std::cout << "(invalid)" << std::endl;
+  }
+}
+
+int main() {
+  std::cout << "ParseEightDigits(\"12345678\") = " << ParseEightDigits("12345678") << std::endl;
+  std::cout << "ParseSixteenDigits(\"1234567890123456\") = "
+            << ParseSixteenDigits("1234567890123456") << std::endl;
+  std::cout << std::endl;
+
+  TestParse<int>("0");
+  TestParse<int>("-2147483648");
+  TestParse<int>("2147483648");
+  TestParse<int>("12a");
+  TestParse<int>("");
+  TestParse<int8_t>("-128");
+  TestParse<uint8_t>("256");
+  TestParse<uint64_t>("18446744073709551615");
+  TestParse<uint64_t>("18446744073709551616");
+  TestParse<int64_t>("-9223372036854775808");
+  TestParse<unsigned>("-1");
+  TestParse<long>("0000000000000000000000042");
+  std::cout << std::endl;
+
+  TestParse<double>("3.14159");
+  TestParse<double>("-1e-300");
+  TestParse<float>("1.5e10");
+  TestParse<double>("1.5.");
+  std::cout << std::endl;
+
+  std::vector<std::string_view> column{"10", "20", "30", "-40"};
+  std::vector<long> values;
+  if (ParseColumn(column, values)) {
+    for (long value : values) {
+      std::cout << value << " ";
+    }
+    std::cout << std::endl;
+  }
+  column.push_back("x");
+  size_t bad_index = 0;
+  if (!ParseColumn(column, values, &bad_index)) {
+    std::cout << "Bad field at index " << bad_index << std::endl;
+  }
+
+  return 0;
+}
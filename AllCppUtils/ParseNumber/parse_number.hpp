@@ -0,0 +1,179 @@
+#ifndef PARSE_NUMBER_HPP
+#define PARSE_NUMBER_HPP
+
+#include <charconv> // std::from_chars
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace parse_number_internal {
+
+// Unsigned 64-bit values never have more than 19 digits that are guaranteed to fit
+constexpr size_t kMaxFastDigits = 19;
+
+inline uint64_t LoadEightChars(const char* chars) {
+  uint64_t value;
+  std::memcpy(&value, chars, sizeof(value));
+  return value;
+}
+
+// True iff all 8 bytes (loaded little-endian) are '0' through '9'
+inline bool IsEightDigits(uint64_t chars) {
+  return (((chars & 0xF0F0F0F0F0F0F0F0) |
+           (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333);
+}
+
+inline bool IsSixteenDigits(const char* chars) {
+#ifdef __SSE2__
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+  __m128i offset = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+  __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+  return _mm_movemask_epi8(in_range) == 0xFFFF;
+#else
+  return IsEightDigits(LoadEightChars(chars)) && IsEightDigits(LoadEightChars(chars + 8));
+#endif
+}
+
+}  // namespace parse_number_internal
+
+// Parses exactly 8 ASCII digits with SWAR multiplies, digits must already be validated
+inline uint32_t ParseEightDigits(const char* chars) {
+  uint64_t value = parse_number_internal::LoadEightChars(chars);
+  value = ((value & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;  // Pairs: 10 * 2^8 + 1
+  value = ((value & 0x00FF00FF00FF00FF) * 6553601) >> 16;  // Quads: 100 * 2^16 + 1
+  return static_cast<uint32_t>(((value & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+}
+
+// Parses exactly 16 ASCII digits, digits must already be validated
+inline uint64_t ParseSixteenDigits(const char* chars) {
+#ifdef __SSSE3__
+  __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(chars)),
+                                _mm_set1_epi8('0'));
+  __m128i pairs = _mm_maddubs_epi16(digits, _mm_set_epi8(1, 10, 1, 10, 1, 10, 1, 10,
+                                                         1, 10, 1, 10, 1, 10, 1, 10));
+  __m128i quads = _mm_madd_epi16(pairs, _mm_set_epi16(1, 100, 1, 100, 1, 100, 1, 100));
+  __m128i packed = _mm_packs_epi32(quads, quads);
+  __m128i octets = _mm_madd_epi16(packed, _mm_set_epi16(1, 10000, 1, 10000, 1, 10000, 1, 10000));
+  uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+  uint64_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+  return high * 100000000 + low;
+#else
+  return static_cast<uint64_t>(ParseEightDigits(chars)) * 100000000 + ParseEightDigits(chars + 8);
+#endif
+}
+
+namespace parse_number_internal {
+
+// Parses up to kMaxFastDigits ASCII digits, fails on any non-digit char
+inline bool ParseDigits(std::string_view digits, uint64_t& value) {
+  const char* chars = digits.data();
+  size_t num_digits = digits.size();
+  size_t i = 0;
+  value = 0;
+  if (num_digits >= 16) {
+    if (!IsSixteenDigits(chars)) {
+      return false;
+    }
+    value = ParseSixteenDigits(chars);
+    i = 16;
+  } else if (num_digits >= 8) {
+    if (!IsEightDigits(LoadEightChars(chars))) {
+      return false;
+    }
+    value = ParseEightDigits(chars);
+    i = 8;
+  }
+  for (; i < num_digits; ++i) {
+    unsigned digit = static_cast<unsigned char>(chars[i]) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+}  // namespace parse_number_internal
+
+// Parses the whole of s as a base-10 integer (same syntax as std::from_chars: optional '-' for
+// signed types, no leading '+' or whitespace). Returns std::nullopt on bad syntax or overflow.
+template <typename IntType>
+std::optional<IntType> ParseInt(std::string_view s) {
+  static_assert(std::is_integral<IntType>::value, "Integral type required");
+  using UnsignedType = typename std::make_unsigned<IntType>::type;
+  bool negative = std::is_signed<IntType>::value && !s.empty() && s[0] == '-';
+  std::string_view digits = s.substr(negative ? 1 : 0);
+  if (!digits.empty() && digits.size() <= parse_number_internal::kMaxFastDigits) {
+    uint64_t magnitude;
+    if (!parse_number_internal::ParseDigits(digits, magnitude)) {
+      return std::nullopt;
+    }
+    uint64_t max_magnitude = static_cast<uint64_t>(std::numeric_limits<IntType>::max()) + negative;
+    if (magnitude > max_magnitude) {
+      return std::nullopt;
+    }
+    UnsignedType unsigned_value = static_cast<UnsignedType>(magnitude);
+    return static_cast<IntType>(negative ? UnsignedType(0) - unsigned_value : unsigned_value);
+  }
+  // Long inputs (leading zeros or overflow) are left to the standard library
+  IntType value;
+  std::from_chars_result result = std::from_chars(s.data(), s.data() + s.size(), value);
+  if (result.ec != std::errc() || result.ptr != s.data() + s.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Parses the whole of s as a floating point value (std::from_chars general format)
+template <typename FloatType>
+std::optional<FloatType> ParseFloat(std::string_view s) {
+  static_assert(std::is_floating_point<FloatType>::value, "Float type required");
+  FloatType value;
+  std::from_chars_result result = std::from_chars(s.data(), s.data() + s.size(), value);
+  if (result.ec != std::errc() || result.ptr != s.data() + s.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Dispatches to ParseInt or ParseFloat
+template <typename NumberType>
+std::optional<NumberType> ParseNumber(std::string_view s) {
+  if constexpr (std::is_floating_point<NumberType>::value) {
+    return ParseFloat<NumberType>(s);
+  } else {
+    return ParseInt<NumberType>(s);
+  }
+}
+
+// Parses a column of fields (e.g. one column of a TSV gathered with SplitFields) into output.
+// Returns false at the first unparseable field and stores its index in bad_index if given.
+template <typename NumberType>
+bool ParseColumn(const std::vector<std::string_view>& fields, std::vector<NumberType>& output,
+                 size_t* bad_index = nullptr) {
+  output.resize(fields.size());
+  for (size_t i = 0; i < fields.size(); ++i) {
+    std::optional<NumberType> value = ParseNumber<NumberType>(fields[i]);
+    if (!value) {
+      if (bad_index != nullptr) {
+        *bad_index = i;
+      }
+      return false;
+    }
+    output[i] = *value;
+  }
+  return true;
+}
+
+#endif  // PARSE_NUMBER_HPP
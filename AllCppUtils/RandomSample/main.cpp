@@ -0,0 +1,31 @@
+#include <iostream>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../common/vector_ostream.hpp"
+#include "random_sample.hpp"
+
+int main() {
+  const int kNumElements = 10;
+  for (int num_samples = 0; num_samples <= kNumElements; ++num_samples) {
+    std::cout << RandomSample(num_samples, kNumElements) << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Both versions make the same draws, so a seeded engine gives the same sample
+  std::mt19937 engine(42);
+  std::mt19937 naive_engine(42);
+  std::cout << RandomSample(5, 1000, engine) << std::endl;
+  std::cout << RandomSampleNaive(5, 1000, naive_engine) << " (naive)" << std::endl;
+  // Memory is O(num_samples), so the population can be huge
+  std::cout << RandomSample(int64_t{3}, int64_t{1} << 40) << std::endl;
+
+  try {
+    RandomSample(11, kNumElements);
+  } catch (const std::invalid_argument& error) {
+    std::cout << "RandomSample(11, 10): " << error.what() << std::endl;
+  }
+  return 0;
+}
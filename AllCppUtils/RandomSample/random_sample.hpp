@@ -0,0 +1,70 @@
+#ifndef RANDOM_SAMPLE_HPP
+#define RANDOM_SAMPLE_HPP
+
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace random_sample_internal {
+
+template <typename IntType>
+void CheckSampleArguments(IntType num_samples, IntType num_elements) {
+  static_assert(std::is_integral<IntType>::value, "Integral type required");
+  if (num_samples < 0 || num_samples > num_elements) {
+    throw std::invalid_argument("RandomSample: need 0 <= num_samples <= num_elements");
+  }
+}
+
+}  // namespace random_sample_internal
+
+// Random sampling without replacement: num_samples distinct values of [0, num_elements) in
+// random order, from the first num_samples steps of a Fisher-Yates shuffle.
+// O(num_elements) time and space to build the permutation.
+template <typename IntType, typename Engine>
+std::vector<IntType> RandomSampleNaive(IntType num_samples, IntType num_elements, Engine& engine) {
+  random_sample_internal::CheckSampleArguments(num_samples, num_elements);
+  std::vector<IntType> permutation(num_elements);
+  for (IntType i = 0; i < num_elements; ++i) {
+    permutation[i] = i;
+  }
+  for (IntType i = 0; i < num_samples; ++i) {
+    IntType random_index = std::uniform_int_distribution<IntType>(i, num_elements - 1)(engine);
+    std::swap(permutation[random_index], permutation[i]);
+  }
+  permutation.resize(num_samples);
+  return permutation;
+}
+
+// Same shuffle steps (and so the same result for the same engine state) as RandomSampleNaive, but
+// only the positions the shuffle touched are stored, in a hash map.
+// O(num_samples) time and space, independent of num_elements.
+template <typename IntType, typename Engine>
+std::vector<IntType> RandomSample(IntType num_samples, IntType num_elements, Engine& engine) {
+  random_sample_internal::CheckSampleArguments(num_samples, num_elements);
+  std::unordered_map<IntType, IntType> permutation_map;
+  permutation_map.reserve(2 * static_cast<size_t>(num_samples));
+  auto value_at = [&permutation_map](IntType i) {
+    auto it = permutation_map.find(i);
+    return it == permutation_map.end() ? i : it->second;
+  };
+  std::vector<IntType> sample_results(num_samples);
+  for (IntType i = 0; i < num_samples; ++i) {
+    IntType random_index = std::uniform_int_distribution<IntType>(i, num_elements - 1)(engine);
+    IntType random_value = value_at(random_index);
+    // Position i is never read again, only random_index needs the displaced value
+    permutation_map[random_index] = value_at(i);
+    sample_results[i] = random_value;
+  }
+  return sample_results;
+}
+
+// Draws from a per-thread engine seeded from std::random_device
+template <typename IntType>
+std::vector<IntType> RandomSample(IntType num_samples, IntType num_elements) {
+  thread_local std::mt19937_64 engine(std::random_device{}());
+  return RandomSample(num_samples, num_elements, engine);
+}
+
+#endif  // RANDOM_SAMPLE_HPP
@@ -1,56 +1,27 @@
-#include <cmath>
-#include <cstdlib> // std::to_string
-#include <string>
-
-// Fast int power function, assumes exponent is non-negative
-template <typename BaseType, typename ExpType>
-BaseType IntPower(BaseType base, ExpType exponent) {
-  static_assert(std::is_integral<BaseType>::value, "Integral type required for base");
-  static_assert(std::is_integral<ExpType>::value, "Integral type required for exponent");
-  BaseType result = 1;
-  if (base < 0) {
-    result *= (exponent & 1) ? -1 : 1;
-    base *= -1;
-  }
-  while (exponent > 0) {
-    if (exponent & 1) {
-       result *= base;
-    }
-    // Now exponent is even
-    exponent /= 2;
-    base *= base;
-  }
-  return result;
-}
+#ifndef FORMAT_NUMBER_HPP
+#define FORMAT_NUMBER_HPP
 
+#include <string>
+#include <type_traits>
 
+#include "../NumberFormat/number_format.hpp"
 
+// Abbreviated integer with a K/M/B/T (then P/E) suffix: at most one decimal, truncated, and only
+// while the sign and integer part take fewer than 3 chars, e.g. 3968 -> "3.9 K", 98534 ->
+// "98.5 K", -1345365 -> "-1.3 M", -98534 -> "-98 K", 452316167 -> "452 M". Values below 1000
+// are exact. Formatted by number_format::HumanReadable, so the most negative value of every
+// type and values up to 2^64 - 1 work.
 template <typename IntType>
 std::string FormatNumber(IntType num) {
   static_assert(std::is_integral<IntType>::value, "Integral type required");
-  std::string s("");
-  bool negative = num < 0;
-  if (negative) {
-    num = -num;
-    s += '-';
-  }
-	// First multiply by 10 to get one decimal place
-	num *= 10;
-	char SUFFIXES[] = {'K', 'M', 'B', 'T'};
-	const size_t num_suffixes = sizeof(SUFFIXES)/sizeof(SUFFIXES[0]);
-	int suff_idx = -1;
-	while(num >= 10000) {
-	  num /= 1000;
-		suff_idx++;
-	}
-	IntType int_part = num/10;
-	IntType dec_part = num%10;
-	s += std::to_string(int_part);
-	if (dec_part && (s.length() < 3)) {
-	  s += "." + std::to_string(dec_part);
-  }
-	if (suff_idx >= 0) {
-	  s += std::string(" ") + SUFFIXES[suff_idx];
-  }
-	return s;
+  number_format::HumanReadable policy;
+  // A '-' takes the place of one digit
+  policy.sig_figs = num < 0 ? 2 : 3;
+  policy.max_decimals = 1;
+  policy.truncate = true;
+  policy.trim_zeros = true;
+  policy.suffix_separator = " ";
+  return number_format::Format(num, policy);
 }
+
+#endif  // FORMAT_NUMBER_HPP
@@ -1,5 +1,7 @@
+#include <climits> // INT_MIN
 #include <iostream>
 
+#include "../ScientificNotation/scientific_notation.hpp"
 #include "format_number.hpp"
 
 int main() {
@@ -25,6 +27,7 @@ int main() {
   
   std::cout << std::endl << "2^32 - 1 = " << FormatNumber(4294967295) << std::endl;
   std::cout << std::endl << "2^64 - 1 = " << FormatNumber(18446744073709551615UL) << std::endl;
+  std::cout << "INT_MIN = " << FormatNumber(INT_MIN) << std::endl;
   
   std::cout << std::endl;
   std::cout << SciNotation(3.145, 2) << std::endl;
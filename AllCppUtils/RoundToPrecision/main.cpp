@@ -1,4 +1,9 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring> // std::memcpy, std::memcmp
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "round_to_precision.hpp"
 
@@ -23,5 +28,66 @@ int main() {
   std::cout << std::endl;
   std::cout << RoundToPrecision(123.7, -2) << std::endl;
   
+  std::cout << RoundToPrecision(-1250.0, -2) << std::endl;
+  std::cout << RoundToPrecision(0.1 + 0.2, 400) << std::endl;
+  std::cout << RoundToPrecision(12345.0, -400) << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "Binary vs decimal-exact:" << std::endl;
+  for (double price : {2.675, 1.005, -0.125, 1.15, 9.995}) {
+    std::cout << price << ": " << RoundToPrecision(price, 2) << " vs "
+              << RoundToPrecisionDecimal(price, 2) << std::endl;
+  }
+  std::cout << RoundToPrecisionDecimal(1234.5, -2) << " " << RoundToPrecisionDecimal(0.006, 2)
+            << " " << RoundToPrecisionDecimal(0.004, 2) << std::endl;
+  std::vector<double> decimal_rounded;
+  RoundToPrecision(std::vector<double>{2.675}, decimal_rounded, 2, RoundingMode::kDecimalExact);
+  std::cout << "Batch decimal-exact 2.675 -> " << decimal_rounded[0] << std::endl;
+
+  // Batch (AVX when available) must match scalar std::round bit for bit
+  std::mt19937_64 rng(5);
+  std::vector<double> prices(1000000);
+  for (size_t i = 0; i < prices.size(); ++i) {
+    if (i % 3 == 0) {
+      uint64_t bits = rng();
+      std::memcpy(&prices[i], &bits, sizeof(double));  // Any bit pattern, including inf and nan
+    } else {
+      prices[i] = static_cast<double>(static_cast<int64_t>(rng() % 2000000000) - 1000000000) / 8;
+    }
+  }
+  std::vector<double> rounded;
+  int num_failures = 0;
+  for (int precision : {-3, -1, 0, 1, 2, 4, 9, 17, 320}) {
+    RoundToPrecision(prices, rounded, precision);
+    for (size_t i = 0; i < prices.size(); ++i) {
+      double expected = RoundToPrecision(prices[i], precision);
+      if (std::memcmp(&expected, &rounded[i], sizeof(double)) != 0) {
+        ++num_failures;
+      }
+    }
+  }
+  std::vector<float> float_prices(prices.begin(), prices.end());
+  std::vector<float> float_rounded;
+  for (int precision : {-2, 0, 1, 3}) {
+    RoundToPrecision(float_prices, float_rounded, precision);
+    for (size_t i = 0; i < float_prices.size(); ++i) {
+      float expected = RoundToPrecision(float_prices[i], precision);
+      if (std::memcmp(&expected, &float_rounded[i], sizeof(float)) != 0) {
+        ++num_failures;
+      }
+    }
+  }
+  std::cout << std::endl << "Batch vs scalar: " << num_failures << " mismatches" << std::endl;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < prices.size(); ++i) {
+    rounded[i] = RoundToPrecision(prices[i], 2);
+  }
+  auto mid = std::chrono::steady_clock::now();
+  RoundToPrecision(prices, rounded, 2);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Scalar loop: " << std::chrono::duration<double>(mid - start).count() << " s, "
+            << "batch: " << std::chrono::duration<double>(end - mid).count() << " s" << std::endl;
+
   return 0;
 }
@@ -1,31 +1,226 @@
-#include <cmath> // std::round
+#ifndef ROUND_TO_PRECISION_HPP
+#define ROUND_TO_PRECISION_HPP
+
+#include <charconv> // std::to_chars, std::from_chars
+#include <cmath> // std::round, std::fabs
+#include <cstddef>
+#include <limits>
 #include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// kBinary rounds value * 10^precision in binary floating point, like std::round. kDecimalExact
+// rounds the shortest decimal representation of the value (half away from zero), so prices such
+// as 2.675 (stored as 2.67499999...) round to 2.68 as written rather than 2.67.
+enum class RoundingMode {
+  kBinary,
+  kDecimalExact
+};
+
+namespace round_to_precision_internal {
+
+// 10^0 .. 10^22 are exact in a double
+constexpr double kExactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+    1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+template <typename FloatType>
+FloatType PowerOfTen(int exponent) {
+  if (exponent < 23) {
+    return static_cast<FloatType>(kExactPowersOfTen[exponent]);
+  }
+  return static_cast<FloatType>(std::pow(10.0L, exponent));
+}
+
+// Scaled values at least this large are already integers (or inf / nan), the input is returned
+// unchanged for them
+template <typename FloatType>
+constexpr FloatType kIntegralThreshold =
+    static_cast<FloatType>(1ULL << (std::numeric_limits<FloatType>::digits - 1));
+
+template <typename FloatType>
+FloatType RoundScaled(FloatType value, FloatType scale, bool negative_precision) {
+  FloatType scaled = negative_precision ? value / scale : value * scale;
+  if (!(std::fabs(scaled) < kIntegralThreshold<FloatType>)) {
+    return value;
+  }
+  FloatType rounded = std::round(scaled);
+  return negative_precision ? rounded * scale : rounded / scale;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// std::round semantics (half away from zero) with SIMD instructions: truncating
+// x + copysign(0.49999999999999994, x) rounds correctly for every |x| < 2^52
+__attribute__((target("avx")))
+inline void RoundScaledAvx(const double* input, double* output, size_t count, double scale,
+                           bool negative_precision) {
+  const __m256d scale_vec = _mm256_set1_pd(scale);
+  const __m256d almost_half = _mm256_set1_pd(0.49999999999999994);
+  const __m256d sign_mask = _mm256_set1_pd(-0.0);
+  const __m256d threshold = _mm256_set1_pd(kIntegralThreshold<double>);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d value = _mm256_loadu_pd(input + i);
+    __m256d scaled = negative_precision ? _mm256_div_pd(value, scale_vec) :
+                                          _mm256_mul_pd(value, scale_vec);
+    __m256d offset = _mm256_or_pd(_mm256_and_pd(scaled, sign_mask), almost_half);
+    __m256d rounded = _mm256_round_pd(_mm256_add_pd(scaled, offset),
+                                      _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d result = negative_precision ? _mm256_mul_pd(rounded, scale_vec) :
+                                          _mm256_div_pd(rounded, scale_vec);
+    // Keep the input where |scaled| >= 2^52 or is nan (ordered compare is false)
+    __m256d in_range = _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, scaled), threshold, _CMP_LT_OQ);
+    _mm256_storeu_pd(output + i, _mm256_blendv_pd(value, result, in_range));
+  }
+  for (; i < count; ++i) {
+    output[i] = RoundScaled(input[i], scale, negative_precision);
+  }
+}
+
+__attribute__((target("avx")))
+inline void RoundScaledAvx(const float* input, float* output, size_t count, float scale,
+                           bool negative_precision) {
+  const __m256 scale_vec = _mm256_set1_ps(scale);
+  const __m256 almost_half = _mm256_set1_ps(0.49999997f);
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  const __m256 threshold = _mm256_set1_ps(kIntegralThreshold<float>);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 value = _mm256_loadu_ps(input + i);
+    __m256 scaled = negative_precision ? _mm256_div_ps(value, scale_vec) :
+                                         _mm256_mul_ps(value, scale_vec);
+    __m256 offset = _mm256_or_ps(_mm256_and_ps(scaled, sign_mask), almost_half);
+    __m256 rounded = _mm256_round_ps(_mm256_add_ps(scaled, offset),
+                                     _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256 result = negative_precision ? _mm256_mul_ps(rounded, scale_vec) :
+                                         _mm256_div_ps(rounded, scale_vec);
+    __m256 in_range = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, scaled), threshold, _CMP_LT_OQ);
+    _mm256_storeu_ps(output + i, _mm256_blendv_ps(value, result, in_range));
+  }
+  for (; i < count; ++i) {
+    output[i] = RoundScaled(input[i], scale, negative_precision);
+  }
+}
+
+inline bool HasAvx() {
+  static const bool has_avx = __builtin_cpu_supports("avx");
+  return has_avx;
+}
+
+#endif
 
-// Fast int power function, assumes exponent is non-negative
-template <typename BaseType, typename ExpType>
-BaseType IntPower(BaseType base, ExpType exponent) {
-  static_assert(std::is_integral<BaseType>::value, "Integral type required for base");
-  static_assert(std::is_integral<ExpType>::value, "Integral type required for exponent");
-  BaseType result = 1;
-  if (base < 0) {
-    result *= (exponent & 1) ? -1 : 1;
-    base *= -1;
-  }
-  while (exponent > 0) {
-    if (exponent & 1) {
-       result *= base;
+}  // namespace round_to_precision_internal
+
+// Rounds to precision decimal places, negative precision rounds to tens, hundreds, ...
+template <typename FloatType>
+FloatType RoundToPrecision(FloatType value, int precision) {
+  static_assert(std::is_floating_point<FloatType>::value, "Float type required for value");
+  bool negative_precision = precision < 0;
+  FloatType scale = round_to_precision_internal::PowerOfTen<FloatType>(
+      negative_precision ? -precision : precision);
+  if (negative_precision && !std::isfinite(scale)) {
+    return std::isnan(value) ? value : std::copysign(FloatType(0), value);
+  }
+  return round_to_precision_internal::RoundScaled(value, scale, negative_precision);
+}
+
+// Rounds the shortest round-trip decimal digits of value half away from zero, see RoundingMode
+template <typename FloatType>
+FloatType RoundToPrecisionDecimal(FloatType value, int precision) {
+  static_assert(std::is_floating_point<FloatType>::value, "Float type required for value");
+  if (!std::isfinite(value) || value == 0) {
+    return value;
+  }
+  // Layout is [-]d[.ddd]e(+|-)XX
+  char chars[64];
+  char* end = std::to_chars(chars, chars + sizeof(chars), value, std::chars_format::scientific).ptr;
+  char* ptr = chars;
+  bool negative = *ptr == '-';
+  ptr += negative ? 1 : 0;
+  char digits[64];
+  int num_digits = 0;
+  for (; *ptr != 'e'; ++ptr) {
+    if (*ptr != '.') {
+      digits[num_digits++] = *ptr;
     }
-    // Now exponent is even
-    exponent /= 2;
-    base *= base;
   }
+  int exponent = 0;
+  ++ptr;
+  std::from_chars(ptr + (*ptr == '+' ? 1 : 0), end, exponent);
+  // Digit i has place value 10^(exponent - i), keep those at or above 10^-precision
+  long long num_kept = static_cast<long long>(exponent) + precision + 1;
+  if (num_kept >= num_digits) {
+    return value;
+  }
+  if (num_kept < 0) {
+    return std::copysign(FloatType(0), value);
+  }
+  char mantissa[72];
+  char* out = mantissa;
+  if (negative) {
+    *out++ = '-';
+  }
+  *out++ = '0';  // Room for a carry out of the leading digit
+  for (long long i = 0; i < num_kept; ++i) {
+    *out++ = digits[i];
+  }
+  if (digits[num_kept] >= '5') {
+    char* carry = out - 1;
+    while (*carry == '9') {
+      *carry-- = '0';
+    }
+    ++*carry;
+  }
+  *out++ = 'e';
+  out = std::to_chars(out, mantissa + sizeof(mantissa), exponent - num_kept + 1).ptr;
+  FloatType result = 0;
+  std::from_chars(mantissa, out, result);
   return result;
 }
 
+// Batch version: input and output hold count values and may be the same array. The scale factor
+// is computed once, kBinary mode uses AVX when the CPU has it.
 template <typename FloatType>
-FloatType RoundToPrecision(FloatType value, int precision) {
+void RoundToPrecision(const FloatType* input, FloatType* output, size_t count, int precision,
+                      RoundingMode mode = RoundingMode::kBinary) {
   static_assert(std::is_floating_point<FloatType>::value, "Float type required for value");
-  FloatType scale_factor = static_cast<FloatType>(IntPower(10, precision));
-  return std::round(value * scale_factor) / scale_factor;
+  if (mode == RoundingMode::kDecimalExact) {
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = RoundToPrecisionDecimal(input[i], precision);
+    }
+    return;
+  }
+  bool negative_precision = precision < 0;
+  FloatType scale = round_to_precision_internal::PowerOfTen<FloatType>(
+      negative_precision ? -precision : precision);
+  if (negative_precision && !std::isfinite(scale)) {
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = RoundToPrecision(input[i], precision);
+    }
+    return;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  if constexpr (std::is_same<FloatType, double>::value || std::is_same<FloatType, float>::value) {
+    if (round_to_precision_internal::HasAvx()) {
+      round_to_precision_internal::RoundScaledAvx(input, output, count, scale, negative_precision);
+      return;
+    }
+  }
+#endif
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = round_to_precision_internal::RoundScaled(input[i], scale, negative_precision);
+  }
+}
+
+template <typename FloatType>
+void RoundToPrecision(const std::vector<FloatType>& input, std::vector<FloatType>& output,
+                      int precision, RoundingMode mode = RoundingMode::kBinary) {
+  output.resize(input.size());
+  RoundToPrecision(input.data(), output.data(), input.size(), precision, mode);
 }
 
+#endif  // ROUND_TO_PRECISION_HPP
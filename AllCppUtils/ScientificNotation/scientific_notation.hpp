@@ -1,15 +1,74 @@
-#include <iomanip> // std::setprecision
-#include <sstream>
+#ifndef SCIENTIFIC_NOTATION_HPP
+#define SCIENTIFIC_NOTATION_HPP
+
+#include <charconv> // std::to_chars
 #include <string>
+#include <string_view>
 #include <type_traits>
-  
+
+// Enough for any double in scientific notation with precision up to 40, and for the shortest
+// round-trip form of any double
+constexpr size_t kSciNotationBufferSize = 64;
+
+// Allocation-free SciNotation: writes e.g. "-1.235e+02" into buffer and returns a view of it.
+// Same output as std::scientific with setprecision(precision) (a negative precision means 6, like
+// printf), formatted by std::to_chars so there is no stream or locale per call.
+// Precision is capped so the result fits the buffer.
+template <typename NumberType, size_t N>
+std::string_view SciNotationTo(char (&buffer)[N], NumberType value, int precision = 3) {
+  static_assert(std::is_arithmetic<NumberType>::value, "Arithmetic type required");
+  static_assert(N >= kSciNotationBufferSize, "Buffer must hold kSciNotationBufferSize chars");
+  if (precision < 0) {
+    precision = 6;
+  }
+  if (precision > static_cast<int>(N) - 24) {
+    precision = static_cast<int>(N) - 24;
+  }
+  std::to_chars_result result;
+  if constexpr (std::is_floating_point<NumberType>::value) {
+    result = std::to_chars(buffer, buffer + N, value, std::chars_format::scientific, precision);
+  } else {
+    result = std::to_chars(buffer, buffer + N, static_cast<double>(value),
+                           std::chars_format::scientific, precision);
+  }
+  return std::string_view(buffer, result.ptr - buffer);
+}
+
+// Shortest scientific notation that parses back to exactly the same value, e.g. 0.1 -> "1e-01"
+// rather than "1.000000000000000055511151231257827e-01"
+template <typename FloatType, size_t N>
+std::string_view ShortestSciNotationTo(char (&buffer)[N], FloatType value) {
+  static_assert(std::is_floating_point<FloatType>::value, "Float type required");
+  static_assert(N >= kSciNotationBufferSize, "Buffer must hold kSciNotationBufferSize chars");
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + N, value, std::chars_format::scientific);
+  return std::string_view(buffer, result.ptr - buffer);
+}
+
+// Shortest round-trip representation in whichever of fixed or scientific notation is shorter,
+// e.g. 0.1 -> "0.1", 1e22 -> "1e+22"
+template <typename FloatType, size_t N>
+std::string_view ShortestFloatTo(char (&buffer)[N], FloatType value) {
+  static_assert(std::is_floating_point<FloatType>::value, "Float type required");
+  static_assert(N >= kSciNotationBufferSize, "Buffer must hold kSciNotationBufferSize chars");
+  std::to_chars_result result = std::to_chars(buffer, buffer + N, value);
+  return std::string_view(buffer, result.ptr - buffer);
+}
+
 // Returns std::string containg scientific notation with given precision, float version
 template <typename FloatType>
 typename std::enable_if<std::is_floating_point<FloatType>::value, std::string>::type
 SciNotation(FloatType value, int precision = 3) {
-  std::stringstream ss;
-  ss << std::scientific << std::setprecision(precision) << value;
-  return ss.str();
+  if (precision + 24 > static_cast<int>(kSciNotationBufferSize)) {
+    // Rare huge precision, format straight into the result instead of the stack buffer
+    std::string result(precision + 24, '\0');
+    std::to_chars_result to_chars_result = std::to_chars(
+        &result[0], &result[0] + result.size(), value, std::chars_format::scientific, precision);
+    result.resize(to_chars_result.ptr - result.data());
+    return result;
+  }
+  char buffer[kSciNotationBufferSize];
+  return std::string(SciNotationTo(buffer, value, precision));
 }
 
 // Returns std::string containg scientific notation with given precision, int version
@@ -18,3 +77,17 @@ typename std::enable_if<std::is_integral<IntType>::value, std::string>::type
 SciNotation(IntType value, int precision = 3) {
   return SciNotation(static_cast<double>(value), precision);
 }
+
+template <typename FloatType>
+std::string ShortestSciNotation(FloatType value) {
+  char buffer[kSciNotationBufferSize];
+  return std::string(ShortestSciNotationTo(buffer, value));
+}
+
+template <typename FloatType>
+std::string ShortestFloat(FloatType value) {
+  char buffer[kSciNotationBufferSize];
+  return std::string(ShortestFloatTo(buffer, value));
+}
+
+#endif  // SCIENTIFIC_NOTATION_HPP
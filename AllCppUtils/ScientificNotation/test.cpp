@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio> // std::snprintf
+#include <cstdlib> // std::strtod
+#include <cstring> // std::memcpy
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "scientific_notation.hpp"
+
+// Random doubles over the whole range: random bit patterns (finite only) plus "nice" decimals
+double RandomDouble(std::mt19937_64& rng) {
+  if (rng() % 2 == 0) {
+    return static_cast<double>(static_cast<int64_t>(rng() % 2000001) - 1000000) / 1000.0;
+  }
+  double value;
+  do {
+    uint64_t bits = rng();
+    std::memcpy(&value, &bits, sizeof(value));
+  } while (!std::isfinite(value));
+  return value;
+}
+
+// Compares SciNotation with printf("%.*e") for every precision in [-1, 17]
+int TestAgainstPrintf(std::mt19937_64& rng, int num_values) {
+  int num_failures = 0;
+  char expected[128];
+  for (int i = 0; i < num_values; ++i) {
+    double value = RandomDouble(rng);
+    for (int precision = -1; precision <= 17; ++precision) {
+      std::snprintf(expected, sizeof(expected), "%.*e", precision, value);
+      std::string actual = SciNotation(value, precision);
+      if (actual != expected) {
+        if (++num_failures <= 5) {
+          std::cout << "Mismatch for " << expected << " precision " << precision << ": " << actual
+                    << std::endl;
+        }
+      }
+    }
+  }
+  return num_failures;
+}
+
+// Checks that ShortestSciNotation round-trips and that no printf precision is shorter
+int TestShortest(std::mt19937_64& rng, int num_values) {
+  int num_failures = 0;
+  char expected[128];
+  for (int i = 0; i < num_values; ++i) {
+    double value = RandomDouble(rng);
+    std::string actual = ShortestSciNotation(value);
+    bool round_trips = std::strtod(actual.c_str(), nullptr) == value;
+    // Shortest printf precision that round-trips
+    for (int precision = 0; precision <= 17; ++precision) {
+      std::snprintf(expected, sizeof(expected), "%.*e", precision, value);
+      if (std::strtod(expected, nullptr) == value) {
+        break;
+      }
+    }
+    if (!round_trips || actual.size() > std::string(expected).size()) {
+      if (++num_failures <= 5) {
+        std::cout << "Shortest mismatch: " << actual << " vs " << expected << std::endl;
+      }
+    }
+  }
+  return num_failures;
+}
+
+int main() {
+  std::mt19937_64 rng(2024);
+
+  std::cout << "Special values: " << SciNotation(0.0) << " " << SciNotation(-0.0) << " "
+            << SciNotation(std::numeric_limits<double>::infinity()) << " "
+            << SciNotation(std::numeric_limits<double>::denorm_min(), 5) << " "
+            << SciNotation(std::numeric_limits<double>::max(), 16) << std::endl;
+  std::cout << "Shortest: " << ShortestSciNotation(0.1) << " " << ShortestSciNotation(1.0 / 3)
+            << " " << ShortestFloat(0.1) << " " << ShortestFloat(1e22) << " "
+            << ShortestFloat(123456.0) << std::endl;
+  std::cout << "Large precision: " << SciNotation(1.0 / 3, 60) << std::endl;
+  std::cout << std::endl;
+
+  int num_failures = TestAgainstPrintf(rng, 200000);
+  std::cout << "SciNotation vs printf: " << num_failures << " failures" << std::endl;
+  num_failures = TestShortest(rng, 200000);
+  std::cout << "ShortestSciNotation: " << num_failures << " failures" << std::endl;
+
+  char expected[128];
+  std::snprintf(expected, sizeof(expected), "%.60e", 1.0 / 3);
+  std::cout << "Large precision vs printf: "
+            << (SciNotation(1.0 / 3, 60) == expected ? "ok" : "FAILED") << std::endl;
+
+  return 0;
+}
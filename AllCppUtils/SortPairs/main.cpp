@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/timer.hpp"
+#include "../common/vector_ostream.hpp"
+#include "sort_pairs.hpp"
+
+int main() {
+  std::vector<std::pair<size_t, double>> scores{{0, 0.5}, {1, -2.0}, {2, 3.25}, {3, 0.5},
+                                                {4, -0.0}};
+  SortPairsBySecond(scores);
+  std::cout << scores << std::endl;
+  SortPairsBySecond(scores, true);
+  std::cout << scores << " (descending)" << std::endl;
+  std::vector<std::pair<std::string, int>> counts{{"b", 3}, {"a", 10}, {"c", -1}};
+  std::vector<size_t> order = ArgSortBy(counts, [](const auto& p) { return p.second; }, true);
+  std::cout << order << " (indices by count, descending)" << std::endl;
+  std::cout << std::endl;
+
+  // Ranking scored ids, against the README's std::sort with a lambda
+  constexpr size_t kNumPairs = 10000000;
+  std::mt19937_64 engine(2024);
+  std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+  std::vector<std::pair<size_t, double>> pairs(kNumPairs);
+  for (size_t i = 0; i < kNumPairs; ++i) {
+    pairs[i] = {i, distribution(engine)};
+  }
+  Timer timer;
+  std::vector<std::pair<size_t, double>> sorted = pairs;
+  timer.Reset();
+  std::sort(sorted.begin(), sorted.end(), [](const auto& left, const auto& right) {
+    return left.second < right.second;
+  });
+  double std_sort_runtime = timer.GetSeconds();
+  std::vector<std::pair<size_t, double>> radix_sorted = pairs;
+  timer.Reset();
+  SortPairsBySecond(radix_sorted);
+  double radix_runtime = timer.GetSeconds();
+  timer.Reset();
+  std::vector<size_t> indices = ArgSortBy(pairs, [](const auto& p) { return p.second; });
+  double argsort_runtime = timer.GetSeconds();
+  bool same = sorted == radix_sorted;
+  for (size_t i = 0; same && i < kNumPairs; ++i) {
+    same = indices[i] == sorted[i].first;
+  }
+  std::cout << kNumPairs << " pairs: std::sort " << std_sort_runtime << " s, SortPairsBySecond "
+            << radix_runtime << " s, ArgSortBy " << argsort_runtime << " s"
+            << (same ? "" : " (results differ!)") << std::endl;
+  return 0;
+}
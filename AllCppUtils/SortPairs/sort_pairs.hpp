@@ -0,0 +1,237 @@
+#ifndef SORT_PAIRS_HPP
+#define SORT_PAIRS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <type_traits>
+#include <utility> // std::move, std::pair
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+
+// Stable sort by a numeric key, e.g. a vector of (id, score) pairs by score. Integral and
+// float/double keys are mapped to unsigned integers with the same order and sorted with an LSD
+// radix sort, one pass per 11-bit digit of the key (6 passes for 64-bit keys): O(n) per pass, and
+// passes whose digit is the same for every key (e.g. the high digits of small integers) are
+// skipped. Each pass is parallel: every thread counts the digits of its slice, then scatters its
+// slice to offsets that keep equal digits in input order, so the result is the same for any
+// thread count. Other key types fall back to std::stable_sort.
+//
+// Order is by value, with -0.0 before +0.0, and NaNs at the ends (by their sign bit).
+namespace sort_pairs_internal {
+
+template <typename Key>
+constexpr bool kIsRadixKey = (std::is_integral<Key>::value && !std::is_same<Key, bool>::value) ||
+                             std::is_same<Key, float>::value || std::is_same<Key, double>::value;
+
+template <typename Key>
+using RadixKeyType = std::conditional_t<
+    std::is_floating_point<Key>::value,
+    std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>,
+    std::make_unsigned_t<std::conditional_t<std::is_floating_point<Key>::value, int, Key>>>;
+
+// Unsigned integer ordered like key: the sign bit of signed integers is flipped; negative floats
+// have all bits flipped (larger magnitude sorts first), non-negative ones just the sign bit
+template <typename Key>
+RadixKeyType<Key> ToRadixKey(Key key) {
+  using Unsigned = RadixKeyType<Key>;
+  constexpr Unsigned kSignBit = Unsigned(1) << (8 * sizeof(Unsigned) - 1);
+  if constexpr (std::is_floating_point<Key>::value) {
+    Unsigned bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+  } else if constexpr (std::is_signed<Key>::value) {
+    return static_cast<Unsigned>(key) ^ kSignBit;
+  } else {
+    return key;
+  }
+}
+
+// Threads for n elements: at least kMinPerThread elements each, at most num_threads (0 means
+// one per pool thread)
+inline size_t NumSortThreads(size_t n, size_t num_threads) {
+  constexpr size_t kMinPerThread = size_t{1} << 16;
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  return std::max<size_t>(1, std::min(num_threads, n / kMinPerThread));
+}
+
+// Runs fn(thread_i) for thread_i in [0, num_threads) as tasks on the shared thread pool
+template <typename Function>
+void ForEachThread(size_t num_threads, Function fn) {
+  thread_pool::ParallelFor(0, num_threads, 1, fn);
+}
+
+// 2^11 buckets: fewer passes than bytes, while the scatter targets still fit in L2
+constexpr size_t kDigitBits = 11;
+constexpr size_t kNumBuckets = size_t{1} << kDigitBits;
+constexpr size_t kDigitMask = kNumBuckets - 1;
+
+// Stable LSD radix sort of data[0, n) by radix_key(element), an unsigned integer. buffer must
+// hold n elements; the sorted elements end up in data.
+template <typename T, typename RadixKeyFunction>
+void RadixSort(T* data, T* buffer, size_t n, RadixKeyFunction radix_key, size_t num_threads) {
+  using Unsigned = decltype(radix_key(*data));
+  constexpr size_t kNumDigits = (8 * sizeof(Unsigned) + kDigitBits - 1) / kDigitBits;
+  using Histogram = std::array<size_t, kNumBuckets>;
+  num_threads = NumSortThreads(n, num_threads);
+  auto slice_begin = [n, num_threads](size_t thread_i) { return n * thread_i / num_threads; };
+
+  // Counts of every digit position up front, to find the passes that would not move anything
+  std::vector<std::array<Histogram, kNumDigits>> digit_counts(num_threads);
+  ForEachThread(num_threads, [&](size_t thread_i) {
+    std::array<Histogram, kNumDigits>& counts = digit_counts[thread_i];
+    for (Histogram& histogram : counts) {
+      histogram.fill(0);
+    }
+    for (size_t i = slice_begin(thread_i); i < slice_begin(thread_i + 1); ++i) {
+      Unsigned key = radix_key(data[i]);
+      for (size_t digit_i = 0; digit_i < kNumDigits; ++digit_i) {
+        ++counts[digit_i][(key >> (kDigitBits * digit_i)) & kDigitMask];
+      }
+    }
+  });
+
+  T* source = data;
+  T* destination = buffer;
+  std::vector<Histogram> pass_counts(num_threads);
+  std::vector<Histogram> offsets(num_threads);
+  bool elements_moved = false;
+  for (size_t digit_i = 0; digit_i < kNumDigits; ++digit_i) {
+    bool is_constant_digit = false;
+    for (size_t bucket = 0; bucket < kNumBuckets && !is_constant_digit; ++bucket) {
+      size_t bucket_size = 0;
+      for (size_t thread_i = 0; thread_i < num_threads; ++thread_i) {
+        bucket_size += digit_counts[thread_i][digit_i][bucket];
+      }
+      is_constant_digit = bucket_size == n;
+    }
+    if (is_constant_digit) {
+      continue;
+    }
+    // The slices hold other elements once a pass has moved them, so count this digit again
+    if (elements_moved) {
+      ForEachThread(num_threads, [&](size_t thread_i) {
+        Histogram& counts = pass_counts[thread_i];
+        counts.fill(0);
+        for (size_t i = slice_begin(thread_i); i < slice_begin(thread_i + 1); ++i) {
+          ++counts[(radix_key(source[i]) >> (kDigitBits * digit_i)) & kDigitMask];
+        }
+      });
+    } else {
+      for (size_t thread_i = 0; thread_i < num_threads; ++thread_i) {
+        pass_counts[thread_i] = digit_counts[thread_i][digit_i];
+      }
+    }
+    // Slice t's elements with digit d go after all elements with smaller digits, and after those
+    // with digit d in earlier slices
+    size_t offset = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      for (size_t thread_i = 0; thread_i < num_threads; ++thread_i) {
+        offsets[thread_i][bucket] = offset;
+        offset += pass_counts[thread_i][bucket];
+      }
+    }
+    ForEachThread(num_threads, [&](size_t thread_i) {
+      Histogram& slice_offsets = offsets[thread_i];
+      for (size_t i = slice_begin(thread_i); i < slice_begin(thread_i + 1); ++i) {
+        size_t bucket = (radix_key(source[i]) >> (kDigitBits * digit_i)) & kDigitMask;
+        destination[slice_offsets[bucket]++] = std::move(source[i]);
+      }
+    });
+    std::swap(source, destination);
+    elements_moved = true;
+  }
+  if (source != data) {
+    ForEachThread(num_threads, [&](size_t thread_i) {
+      std::move(source + slice_begin(thread_i), source + slice_begin(thread_i + 1),
+                data + slice_begin(thread_i));
+    });
+  }
+}
+
+}  // namespace sort_pairs_internal
+
+// Stable sort of items by key_of(item), ascending unless descending is set (equal keys keep
+// their input order either way). Radix sorted on num_threads threads (0 means one per pool
+// thread) for integral, float and double keys.
+//
+//   SortPairsBy(scored_ids, [](const std::pair<size_t, double>& p) { return p.second; });
+template <typename T, typename KeyFunction>
+void SortPairsBy(std::vector<T>& items, KeyFunction key_of, bool descending = false,
+                 size_t num_threads = 0) {
+  using Key = std::decay_t<decltype(key_of(items[0]))>;
+  // Below this size std::stable_sort beats the radix sort's fixed costs
+  constexpr size_t kMinRadixSize = 4096;
+  if constexpr (sort_pairs_internal::kIsRadixKey<Key>) {
+    auto radix_key = [&key_of, descending](const T& item) {
+      auto key = sort_pairs_internal::ToRadixKey<Key>(key_of(item));
+      return descending ? static_cast<decltype(key)>(~key) : key;
+    };
+    if (items.size() < kMinRadixSize) {
+      std::stable_sort(items.begin(), items.end(), [&radix_key](const T& left, const T& right) {
+        return radix_key(left) < radix_key(right);
+      });
+      return;
+    }
+    std::vector<T> buffer(items.size());
+    sort_pairs_internal::RadixSort(items.data(), buffer.data(), items.size(), radix_key,
+                                   num_threads);
+  } else {
+    std::stable_sort(items.begin(), items.end(), [&key_of, descending](const T& left,
+                                                                       const T& right) {
+      return descending ? key_of(right) < key_of(left) : key_of(left) < key_of(right);
+    });
+  }
+}
+
+// Indices that sort items by key_of(item), stably: items[result[0]] has the smallest key (the
+// largest if descending). items is not modified, only (key, index) pairs are moved.
+template <typename T, typename KeyFunction>
+std::vector<size_t> ArgSortBy(const std::vector<T>& items, KeyFunction key_of,
+                              bool descending = false, size_t num_threads = 0) {
+  using Key = std::decay_t<decltype(key_of(items[0]))>;
+  std::vector<size_t> indices(items.size());
+  if constexpr (sort_pairs_internal::kIsRadixKey<Key>) {
+    using Unsigned = sort_pairs_internal::RadixKeyType<Key>;
+    std::vector<std::pair<Unsigned, size_t>> keyed(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+      Unsigned key = sort_pairs_internal::ToRadixKey<Key>(key_of(items[i]));
+      keyed[i] = {descending ? static_cast<Unsigned>(~key) : key, i};
+    }
+    SortPairsBy(keyed, [](const std::pair<Unsigned, size_t>& item) { return item.first; },
+                false, num_threads);
+    for (size_t i = 0; i < keyed.size(); ++i) {
+      indices[i] = keyed[i].second;
+    }
+  } else {
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = i;
+    }
+    std::stable_sort(indices.begin(), indices.end(), [&](size_t left, size_t right) {
+      return descending ? key_of(items[right]) < key_of(items[left]) :
+                          key_of(items[left]) < key_of(items[right]);
+    });
+  }
+  return indices;
+}
+
+// The README's pair sorts, by .first or .second
+template <typename First, typename Second>
+void SortPairsByFirst(std::vector<std::pair<First, Second>>& pairs, bool descending = false,
+                      size_t num_threads = 0) {
+  SortPairsBy(pairs, [](const std::pair<First, Second>& p) { return p.first; }, descending,
+              num_threads);
+}
+
+template <typename First, typename Second>
+void SortPairsBySecond(std::vector<std::pair<First, Second>>& pairs, bool descending = false,
+                       size_t num_threads = 0) {
+  SortPairsBy(pairs, [](const std::pair<First, Second>& p) { return p.second; }, descending,
+              num_threads);
+}
+
+#endif  // SORT_PAIRS_HPP
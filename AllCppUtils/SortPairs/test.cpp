@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sort_pairs.hpp"
+
+// Keys with many duplicates and extreme values, so stability and the sign transforms matter
+template <typename Key>
+Key RandomKey(std::mt19937_64& rng) {
+  if constexpr (std::is_floating_point<Key>::value) {
+    switch (rng() % 4) {
+      case 0: return static_cast<Key>(static_cast<int>(rng() % 21) - 10) / 4;
+      case 1: return (rng() % 2 ? -1 : 1) * std::numeric_limits<Key>::infinity();
+      case 2: return (rng() % 2 ? -1 : 1) * std::numeric_limits<Key>::denorm_min();
+      default: {
+        using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+        Key value;
+        do {
+          Bits bits = static_cast<Bits>(rng());
+          std::memcpy(&value, &bits, sizeof(value));
+        } while (std::isnan(value));
+        return value;
+      }
+    }
+  } else {
+    return rng() % 2 ? static_cast<Key>(rng()) : static_cast<Key>(rng() % 7);
+  }
+}
+
+// Reference order: operator<, with -0.0 before +0.0 as documented
+template <typename Key>
+bool KeyLess(Key left, Key right) {
+  if constexpr (std::is_floating_point<Key>::value) {
+    if (left == right) {
+      return std::signbit(left) && !std::signbit(right);
+    }
+  }
+  return left < right;
+}
+
+template <typename Key>
+int TestKeyType(const char* name, std::mt19937_64& rng) {
+  int num_failures = 0;
+  for (size_t size : {size_t{0}, size_t{1}, size_t{100}, size_t{4095}, size_t{4096}, size_t{5000},
+                      size_t{300000}}) {
+    std::vector<std::pair<int, Key>> pairs(size);
+    for (size_t i = 0; i < size; ++i) {
+      pairs[i] = {static_cast<int>(i), RandomKey<Key>(rng)};
+    }
+    for (bool descending : {false, true}) {
+      std::vector<std::pair<int, Key>> expected = pairs;
+      std::stable_sort(expected.begin(), expected.end(), [descending](const auto& l,
+                                                                      const auto& r) {
+        return descending ? KeyLess(r.second, l.second) : KeyLess(l.second, r.second);
+      });
+      for (size_t num_threads : {size_t{1}, size_t{3}, size_t{0}}) {
+        std::vector<std::pair<int, Key>> sorted = pairs;
+        SortPairsBySecond(sorted, descending, num_threads);
+        std::vector<size_t> indices = ArgSortBy(pairs, [](const auto& p) { return p.second; },
+                                                descending, num_threads);
+        bool indices_match = indices.size() == size;
+        for (size_t i = 0; indices_match && i < size; ++i) {
+          indices_match = pairs[indices[i]] == expected[i];
+        }
+        if ((sorted != expected || !indices_match) && ++num_failures <= 5) {
+          std::cout << name << ": mismatch for size " << size << ", descending " << descending
+                    << ", " << num_threads << " threads" << std::endl;
+        }
+      }
+    }
+  }
+  std::cout << name << " keys: " << num_failures << " failures" << std::endl;
+  return num_failures;
+}
+
+int main() {
+  std::mt19937_64 rng(48);
+  int num_failures = 0;
+  num_failures += TestKeyType<int8_t>("int8_t", rng);
+  num_failures += TestKeyType<uint16_t>("uint16_t", rng);
+  num_failures += TestKeyType<int32_t>("int32_t", rng);
+  num_failures += TestKeyType<int64_t>("int64_t", rng);
+  num_failures += TestKeyType<uint64_t>("uint64_t", rng);
+  num_failures += TestKeyType<float>("float", rng);
+  num_failures += TestKeyType<double>("double", rng);
+
+  // Non-numeric keys go through std::stable_sort
+  std::vector<std::pair<int, std::string>> words{{0, "pear"}, {1, "apple"}, {2, "fig"},
+                                                 {3, "apple"}};
+  SortPairsBySecond(words);
+  bool words_sorted = words == std::vector<std::pair<int, std::string>>{
+      {1, "apple"}, {3, "apple"}, {2, "fig"}, {0, "pear"}};
+  std::cout << "string keys: " << (words_sorted ? "sorted" : "NOT sorted") << std::endl;
+  num_failures += !words_sorted;
+
+  std::cout << (num_failures == 0 ? "All tests passed" : "Tests FAILED") << std::endl;
+  return num_failures == 0 ? 0 : 1;
+}
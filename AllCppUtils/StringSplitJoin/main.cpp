@@ -1,9 +1,11 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "string_join.hpp"
 #include "string_split.hpp"
+#include "string_table.hpp"
 
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
@@ -44,5 +46,38 @@ int main() {
   std::cout << JoinStrings(SplitString(s, '-', true), "_*_") << std::endl;
   std::cout << JoinStrings(SplitString(s, '-', false), ' ') << std::endl;
   
+  std::cout << std::endl << std::endl;
+  
+  std::vector<std::string_view> views{"alpha", "beta", "gamma"};
+  std::cout << Join(views, ", ") << std::endl;
+  const char* c_strings[] = {"x", "y", "z"};
+  std::cout << Join(c_strings, '/') << std::endl;
+  std::cout << Join(std::vector<int>{1, -22, 333}, '\t') << std::endl;
+  std::cout << Join(std::vector<double>{0.5, 1e-7, 3.0}, " | ") << std::endl;
+  
+  std::string payload("values=");
+  JoinInto(payload, std::vector<long>{4, 8, 15, 16, 23, 42}, ',');
+  std::cout << payload << std::endl;
+  
+  std::cout << std::endl << std::endl;
+  
+  // Parse-transform-emit with one StringTable and one output string reused for every line: once
+  // they have grown to the longest line, no line allocates
+  const char* lines[] = {"id,name,score", "1,ada,97", "2,,88", "3,grace,100"};
+  StringTable fields;
+  StringTable cleaned_fields;
+  std::string output_line;
+  for (const char* line : lines) {
+    SplitString(line, ',', fields, true);
+    // Transform: empty fields become "-", the rest are copied in reverse order
+    cleaned_fields.clear();
+    for (size_t i = fields.size(); i-- > 0;) {
+      cleaned_fields.push_back(fields[i].empty() ? std::string_view("-") : fields[i]);
+    }
+    output_line.clear();
+    JoinInto(output_line, cleaned_fields, " | ");
+    std::cout << fields << " -> " << output_line << std::endl;
+  }
+  
   return 0;
 }
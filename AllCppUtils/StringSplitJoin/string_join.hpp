@@ -1,26 +1,136 @@
-#include <vector>
+#ifndef STRING_JOIN_HPP
+#define STRING_JOIN_HPP
+
+#include <charconv> // std::to_chars
+#include <cstring> // std::memcpy
+#include <iterator> // std::begin, std::end
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
-// Delimiter as char
-std::string JoinStrings(const std::vector<std::string>& input_vector, const char delim) {
-  std::string result("");
-  for (unsigned int i = 0; i < input_vector.size(); i++) {
-    result += input_vector[i];
-    if (i + 1 < input_vector.size()) {
-      result += delim;
-    }
+namespace string_join_internal {
+
+// Large enough for any integer and for the shortest round-trip form of any double
+constexpr size_t kMaxNumberChars = 32;
+
+// Number of chars JoinInto writes for a single element
+template <typename T>
+size_t PieceLength(const T& piece) {
+  if constexpr (std::is_same<T, char>::value) {
+    return 1;
+  } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+    return std::string_view(piece).size();
+  } else {
+    static_assert(std::is_arithmetic<T>::value, "Join requires string-like or numeric elements");
+    char buffer[kMaxNumberChars];
+    return std::to_chars(buffer, buffer + kMaxNumberChars, piece).ptr - buffer;
   }
-  return result;
 }
 
-// Delimiter as string
-std::string JoinStrings(const std::vector<std::string>& input_vector, const std::string& delim) {
-  std::string result("");
-  for (unsigned int i = 0; i < input_vector.size(); i++) {
-    result += input_vector[i];
-    if (i + 1 < input_vector.size()) {
-      result += delim;
-    }
+// Writes a single element at output (which has room for PieceLength(piece) chars)
+template <typename T>
+char* WritePiece(char* output, const T& piece) {
+  if constexpr (std::is_same<T, char>::value) {
+    *output = piece;
+    return output + 1;
+  } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+    std::string_view view(piece);
+    std::memcpy(output, view.data(), view.size());
+    return output + view.size();
+  } else {
+    return std::to_chars(output, output + kMaxNumberChars, piece).ptr;
+  }
+}
+
+// Whether length chars at data lie inside output's current characters
+inline bool PointsInto(const char* data, size_t length, const std::string& output) {
+  const char* output_begin = output.data();
+  return length > 0 && data >= output_begin && data < output_begin + output.size();
+}
+
+// Whether piece (a char of output, or a view of its characters) would dangle once output grows
+template <typename T>
+bool PieceAliases(const T& piece, const std::string& output) {
+  if constexpr (std::is_same<T, char>::value) {
+    return PointsInto(&piece, 1, output);
+  } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+    std::string_view view(piece);
+    return PointsInto(view.data(), view.size(), output);
+  } else {
+    return false;
+  }
+}
+
+}  // namespace string_join_internal
+
+// Appends the elements of range to output, separated by delim. Elements may be anything
+// convertible to std::string_view (std::string, const char*, ...), chars or numbers.
+// The exact output size is computed first, so output grows at most once. range and delim may
+// point into output (e.g. joining views of output's own text); that join goes through a
+// temporary string, like StringTable::push_back copies before it grows.
+template <typename Range>
+void JoinInto(std::string& output, const Range& range, std::string_view delim) {
+  using string_join_internal::PieceAliases;
+  using string_join_internal::PieceLength;
+  using string_join_internal::WritePiece;
+  size_t total_length = 0;
+  size_t num_pieces = 0;
+  bool aliases_output = string_join_internal::PointsInto(delim.data(), delim.size(), output);
+  for (const auto& piece : range) {
+    total_length += PieceLength(piece);
+    aliases_output = aliases_output || PieceAliases(piece, output);
+    ++num_pieces;
   }
+  if (num_pieces == 0) {
+    return;
+  }
+  if (aliases_output) {
+    std::string joined;
+    joined.reserve(total_length + (num_pieces - 1) * delim.size());
+    JoinInto(joined, range, delim);
+    output += joined;
+    return;
+  }
+  total_length += (num_pieces - 1) * delim.size();
+  size_t old_length = output.size();
+  output.resize(old_length + total_length);
+  char* write_ptr = &output[old_length];
+  auto it = std::begin(range);
+  write_ptr = WritePiece(write_ptr, *it);
+  for (++it; it != std::end(range); ++it) {
+    std::memcpy(write_ptr, delim.data(), delim.size());
+    write_ptr = WritePiece(write_ptr + delim.size(), *it);
+  }
+}
+
+template <typename Range>
+void JoinInto(std::string& output, const Range& range, const char delim) {
+  JoinInto(output, range, std::string_view(&delim, 1));
+}
+
+// Joins the elements of range into a new string, separated by delim
+template <typename Range>
+std::string Join(const Range& range, std::string_view delim) {
+  std::string result;
+  JoinInto(result, range, delim);
   return result;
 }
+
+template <typename Range>
+std::string Join(const Range& range, const char delim) {
+  return Join(range, std::string_view(&delim, 1));
+}
+
+// Delimiter as char
+inline std::string JoinStrings(const std::vector<std::string>& input_vector, const char delim) {
+  return Join(input_vector, delim);
+}
+
+// Delimiter as string
+inline std::string JoinStrings(const std::vector<std::string>& input_vector,
+                               const std::string& delim) {
+  return Join(input_vector, std::string_view(delim));
+}
+
+#endif  // STRING_JOIN_HPP
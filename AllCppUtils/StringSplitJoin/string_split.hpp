@@ -1,8 +1,15 @@
+#ifndef STRING_SPLIT_HPP
+#define STRING_SPLIT_HPP
+
+#include <cstring> // std::memchr
 #include <string>
+#include <string_view>
 #include <vector>
 
-std::vector<std::string> SplitString(std::string input_string, const char delim,
-                                     bool retain_empty = false) {
+#include "string_table.hpp"
+
+inline std::vector<std::string> SplitString(std::string input_string, const char delim,
+                                            bool retain_empty = false) {
   std::vector<std::string> results;
   size_t start_i = 0;
   size_t found_i = 0; // dummy initialization to start while loop
@@ -21,3 +28,25 @@ std::vector<std::string> SplitString(std::string input_string, const char delim,
   return results;
 }
 
+// Splits into a reused StringTable: the fields are appended to its buffer, so splitting line after
+// line into the same table allocates only while the table still grows. input must not point into
+// output.
+inline void SplitString(std::string_view input, const char delim, StringTable& output,
+                        bool retain_empty = false) {
+  output.clear();
+  size_t start_i = 0;
+  while (true) {
+    const char* found = (start_i < input.size()) ? static_cast<const char*>(
+        std::memchr(input.data() + start_i, delim, input.size() - start_i)) : nullptr;
+    size_t found_i = found ? static_cast<size_t>(found - input.data()) : input.size();
+    if (found_i > start_i || retain_empty) {
+      output.push_back(input.substr(start_i, found_i - start_i));
+    }
+    if (found == nullptr) {
+      return;
+    }
+    start_i = found_i + 1;
+  }
+}
+
+#endif  // STRING_SPLIT_HPP
@@ -0,0 +1,153 @@
+#ifndef STRING_TABLE_HPP
+#define STRING_TABLE_HPP
+
+#include <cstddef>
+#include <cstring> // std::memcpy
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/container_format.hpp"
+
+// Sequence of strings stored back to back in one char buffer, with an offset array marking where
+// each ends. Replaces std::vector<std::string> for split fields: push_back appends to the buffer
+// instead of allocating per string, and clear() keeps both buffers' capacity, so a table reused
+// across lines stops allocating once it has grown to the largest line. Elements are read as
+// std::string_view, valid until the next push_back or clear.
+class StringTable {
+ public:
+  using value_type = std::string_view;
+  using size_type = size_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    const_iterator() = default;
+    const_iterator(const StringTable* table, size_t index) : table_(table), index_(index) {}
+
+    std::string_view operator*() const { return (*table_)[index_]; }
+    std::string_view operator[](difference_type offset) const {
+      return (*table_)[index_ + offset];
+    }
+
+    const_iterator& operator++() { ++index_; return *this; }
+    const_iterator operator++(int) { const_iterator old = *this; ++index_; return old; }
+    const_iterator& operator--() { --index_; return *this; }
+    const_iterator operator--(int) { const_iterator old = *this; --index_; return old; }
+    const_iterator& operator+=(difference_type offset) { index_ += offset; return *this; }
+    const_iterator& operator-=(difference_type offset) { index_ -= offset; return *this; }
+    const_iterator operator+(difference_type offset) const {
+      return const_iterator(table_, index_ + offset);
+    }
+    const_iterator operator-(difference_type offset) const {
+      return const_iterator(table_, index_ - offset);
+    }
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+    bool operator<(const const_iterator& other) const { return index_ < other.index_; }
+    bool operator>(const const_iterator& other) const { return index_ > other.index_; }
+    bool operator<=(const const_iterator& other) const { return index_ <= other.index_; }
+    bool operator>=(const const_iterator& other) const { return index_ >= other.index_; }
+
+   private:
+    const StringTable* table_ = nullptr;
+    size_t index_ = 0;
+  };
+  using iterator = const_iterator;
+
+  StringTable() = default;
+
+  StringTable(std::initializer_list<std::string_view> strings) {
+    for (std::string_view s : strings) {
+      push_back(s);
+    }
+  }
+
+  // s may point into this table (e.g. push_back(table[0])), it is copied before the buffer grows
+  void push_back(std::string_view s) {
+    size_t old_size = chars_.size();
+    const char* buffer_begin = chars_.data();
+    if (s.data() >= buffer_begin && s.data() < buffer_begin + old_size) {
+      size_t source_offset = s.data() - buffer_begin;
+      chars_.resize(old_size + s.size());
+      std::memcpy(&chars_[old_size], chars_.data() + source_offset, s.size());
+    } else {
+      chars_.append(s.data(), s.size());
+    }
+    ends_.push_back(chars_.size());
+  }
+
+  void pop_back() {
+    ends_.pop_back();
+    chars_.resize(ends_.empty() ? 0 : ends_.back());
+  }
+
+  // Removes all strings but keeps the memory for reuse
+  void clear() {
+    chars_.clear();
+    ends_.clear();
+  }
+
+  void reserve(size_t num_strings, size_t num_chars) {
+    ends_.reserve(num_strings);
+    chars_.reserve(num_chars);
+  }
+
+  std::string_view operator[](size_t index) const {
+    size_t begin = index == 0 ? 0 : ends_[index - 1];
+    return std::string_view(chars_.data() + begin, ends_[index] - begin);
+  }
+
+  std::string_view at(size_t index) const {
+    if (index >= ends_.size()) {
+      throw std::out_of_range("StringTable::at: index out of range");
+    }
+    return (*this)[index];
+  }
+
+  std::string_view front() const { return (*this)[0]; }
+  std::string_view back() const { return (*this)[ends_.size() - 1]; }
+
+  size_t size() const { return ends_.size(); }
+  bool empty() const { return ends_.empty(); }
+  // Total length of all strings
+  size_t NumChars() const { return chars_.size(); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, ends_.size()); }
+
+  friend bool operator==(const StringTable& left, const StringTable& right) {
+    return left.ends_ == right.ends_ && left.chars_ == right.chars_;
+  }
+  friend bool operator!=(const StringTable& left, const StringTable& right) {
+    return !(left == right);
+  }
+
+ private:
+  std::string chars_;
+  std::vector<size_t> ends_;  // ends_[i] is one past the last char of string i
+};
+
+// Same layout as a std::vector<std::string>: ["a", "b"]
+inline std::ostream& operator<<(std::ostream& os, const StringTable& table) {
+  return container_format::WriteToStream(os, table);
+}
+
+inline FastWriter& operator<<(FastWriter& writer, const StringTable& table) {
+  return container_format::WriteToWriter(writer, table);
+}
+
+#endif  // STRING_TABLE_HPP
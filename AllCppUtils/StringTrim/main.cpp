@@ -1,5 +1,7 @@
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "string_trim.hpp"
 
@@ -23,5 +25,21 @@ int main() {
   std::cout << "[" << TrimCopy(s2) << "]" << std::endl;
   
   std::cout << "-- Original string:" << std::endl << "[" << s << "]" << std::endl << std::endl;
+  
+  std::cout << "-- View trims:" << std::endl;
+  std::cout << "[" << LtrimView(s) << "]" << std::endl;
+  std::cout << "[" << RtrimView(s) << "]" << std::endl;
+  std::cout << "[" << TrimView(s) << "]" << std::endl;
+  std::string long_padding(std::string(40, ' ') + "padded" + std::string(37, '\t'));
+  std::cout << "[" << TrimView(long_padding) << "]" << std::endl;
+  std::cout << std::endl;
+  
+  std::cout << "-- Batch trim:" << std::endl;
+  std::vector<std::string_view> fields{"  a ", "\tbb\t", "   ", "c"};
+  TrimAll(fields);
+  for (std::string_view field : fields) {
+    std::cout << "[" << field << "]";
+  }
+  std::cout << std::endl;
   return 0;
 }
@@ -1,42 +1,139 @@
-#include <algorithm> // std::find_if
-#include <cctype> // std::isspace
+#ifndef STRING_TRIM_HPP
+#define STRING_TRIM_HPP
+
+#include <array>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace string_trim_internal {
+
+// Same characters as std::isspace in the "C" locale, without the per-call locale lookup
+constexpr std::array<bool, 256> MakeWhitespaceTable() {
+  std::array<bool, 256> table{};
+  table[static_cast<unsigned char>(' ')] = true;
+  table[static_cast<unsigned char>('\t')] = true;
+  table[static_cast<unsigned char>('\n')] = true;
+  table[static_cast<unsigned char>('\v')] = true;
+  table[static_cast<unsigned char>('\f')] = true;
+  table[static_cast<unsigned char>('\r')] = true;
+  return table;
+}
+
+constexpr std::array<bool, 256> kWhitespaceTable = MakeWhitespaceTable();
+
+constexpr bool IsWhitespace(char ch) {
+  return kWhitespaceTable[static_cast<unsigned char>(ch)];
+}
+
+#ifdef __SSE2__
+// Bit i set iff data[i] is whitespace: ' ' or '\t' through '\r'
+inline unsigned WhitespaceMask16(const char* data) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  __m128i is_space = _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '));
+  __m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8('\t'));
+  __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(4)), offset);
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(is_space, in_range)));
+}
+#endif
+
+// Number of leading whitespace chars
+inline size_t LeadingWhitespace(std::string_view s) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= s.size(); i += 16) {
+    unsigned non_space = ~WhitespaceMask16(s.data() + i) & 0xFFFFu;
+    if (non_space != 0) {
+      return i + __builtin_ctz(non_space);
+    }
+  }
+#endif
+  while (i < s.size() && IsWhitespace(s[i])) {
+    ++i;
+  }
+  return i;
+}
+
+// Number of trailing whitespace chars
+inline size_t TrailingWhitespace(std::string_view s) {
+  size_t end = s.size();
+#ifdef __SSE2__
+  for (; end >= 16; end -= 16) {
+    unsigned non_space = ~WhitespaceMask16(s.data() + end - 16) & 0xFFFFu;
+    if (non_space != 0) {
+      return s.size() - (end - 16 + (31 - __builtin_clz(non_space)) + 1);
+    }
+  }
+#endif
+  while (end > 0 && IsWhitespace(s[end - 1])) {
+    --end;
+  }
+  return s.size() - end;
+}
+
+}  // namespace string_trim_internal
+
+// Trim from left, returns a view into s (no copy)
+inline std::string_view LtrimView(std::string_view s) {
+  s.remove_prefix(string_trim_internal::LeadingWhitespace(s));
+  return s;
+}
+
+// Trim from right, returns a view into s (no copy)
+inline std::string_view RtrimView(std::string_view s) {
+  s.remove_suffix(string_trim_internal::TrailingWhitespace(s));
+  return s;
+}
+
+// Trim from both sides, returns a view into s (no copy)
+inline std::string_view TrimView(std::string_view s) {
+  return RtrimView(LtrimView(s));
+}
+
+// Trims every view in place, e.g. the fields produced by SplitFields
+inline void TrimAll(std::string_view* fields, size_t num_fields) {
+  for (size_t i = 0; i < num_fields; ++i) {
+    fields[i] = TrimView(fields[i]);
+  }
+}
+
+inline void TrimAll(std::vector<std::string_view>& fields) {
+  TrimAll(fields.data(), fields.size());
+}
 
 // Trim from left, in-place
 static inline void Ltrim(std::string &s) {
-  s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-    return !std::isspace(ch);
-  }));
+  s.erase(0, string_trim_internal::LeadingWhitespace(s));
 }
 
 // Trim from right, in-place
 static inline void Rtrim(std::string &s) {
-  s.erase(std::find_if(s.rbegin(), s.rend(), [](int ch) {
-    return !std::isspace(ch);
-  }).base(), s.end());  // .base() gets forward iterator from reverse
+  s.resize(s.size() - string_trim_internal::TrailingWhitespace(s));
 }
 
 // Trim from both sides, in-place
 static inline void Trim(std::string &s) {
-    Ltrim(s);
     Rtrim(s);
+    Ltrim(s);
 }
 
 // Trim from left, makes copy
-static inline std::string LtrimCopy(std::string s) {
-  Ltrim(s);
-  return s;
+static inline std::string LtrimCopy(std::string_view s) {
+  return std::string(LtrimView(s));
 }
 
 // Trim from right, makes copy
-static inline std::string RtrimCopy(std::string s) {
-  Rtrim(s);
-  return s;
+static inline std::string RtrimCopy(std::string_view s) {
+  return std::string(RtrimView(s));
 }
 
 // Trim from both sides, makes copy
-static inline std::string TrimCopy(std::string s) {
-  Trim(s);
-  return s;
+static inline std::string TrimCopy(std::string_view s) {
+  return std::string(TrimView(s));
 }
 
+#endif  // STRING_TRIM_HPP
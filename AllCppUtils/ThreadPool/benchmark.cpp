@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+#include "../common/timer.hpp"
+
+// Spawn and steal overhead of the thread pool, in ns per task with empty task bodies:
+//
+//   g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark && ./benchmark -threads=8 -pin
+//
+// - spawn from outside: a non-pool thread runs tasks through the injection queue
+// - spawn from a worker: one task spawns the rest onto its own deque, the other workers steal;
+//   the share of tasks run on another thread than the spawner is the steal rate
+// - ParallelFor: the lazy binary splitting cost per index at grain 1, and per call at a coarse
+//   grain, where it is the cost of waking the pool
+// - std::thread: a thread started and joined per task, what the pool replaces
+namespace {
+
+volatile size_t sink = 0;
+
+void PrintRow(const std::string& name, double seconds, size_t count,
+              const std::string& unit = "task") {
+  std::cout << name << ": " << seconds * 1e9 / static_cast<double>(count) << " ns per " << unit
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  thread_pool::Options options;
+  for (int arg_i = 1; arg_i < argc; ++arg_i) {
+    if (std::strncmp(argv[arg_i], "-threads=", 9) == 0) {
+      options.num_threads = std::strtoul(argv[arg_i] + 9, nullptr, 10);
+    } else if (std::strcmp(argv[arg_i], "-pin") == 0) {
+      options.pin_threads = true;
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [-threads=N] [-pin]" << std::endl;
+      return 1;
+    }
+  }
+  thread_pool::ThreadPool pool(options);
+  std::cout << pool.NumThreads() << " threads" << (options.pin_threads ? ", pinned" : "")
+            << std::endl;
+  constexpr size_t kNumTasks = 1000000;
+  Timer timer;
+
+  {
+    timer.Reset();
+    thread_pool::TaskGroup group(pool);
+    for (size_t i = 0; i < kNumTasks; ++i) {
+      group.Run([]() { sink = sink + 1; });
+    }
+    group.Wait();
+    PrintRow("spawn + wait from outside", timer.GetSeconds(), kNumTasks);
+  }
+
+  {
+    std::atomic<size_t> num_stolen(0);
+    timer.Reset();
+    thread_pool::TaskGroup outer(pool);
+    outer.Run([&]() {
+      std::thread::id spawner = std::this_thread::get_id();
+      thread_pool::TaskGroup group(pool);
+      for (size_t i = 0; i < kNumTasks; ++i) {
+        group.Run([&num_stolen, spawner]() {
+          if (std::this_thread::get_id() != spawner) {
+            num_stolen.fetch_add(1, std::memory_order_relaxed);
+          }
+        });
+      }
+      group.Wait();
+    });
+    outer.Wait();
+    PrintRow("spawn + wait from a worker", timer.GetSeconds(), kNumTasks);
+    std::cout << "  stolen: " << 100.0 * static_cast<double>(num_stolen.load()) / kNumTasks
+              << "% of tasks" << std::endl;
+  }
+
+  {
+    timer.Reset();
+    thread_pool::ParallelFor(0, kNumTasks, 1, [](size_t) { sink = sink + 1; }, pool);
+    PrintRow("ParallelFor, grain 1", timer.GetSeconds(), kNumTasks);
+  }
+
+  {
+    constexpr size_t kNumCalls = 10000;
+    timer.Reset();
+    for (size_t call = 0; call < kNumCalls; ++call) {
+      thread_pool::ParallelFor(0, 64 * pool.NumThreads(), 64, [](size_t) { sink = sink + 1; },
+                               pool);
+    }
+    PrintRow("ParallelFor, one piece per thread", timer.GetSeconds(), kNumCalls, "call");
+  }
+
+  {
+    constexpr size_t kNumThreads = 2000;
+    timer.Reset();
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      std::thread thread([]() { sink = sink + 1; });
+      thread.join();
+    }
+    PrintRow("std::thread start + join", timer.GetSeconds(), kNumThreads, "thread");
+  }
+  return 0;
+}
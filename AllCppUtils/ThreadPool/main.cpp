@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+#include "../common/timer.hpp"
+
+// Quicksort with the two halves as tasks: nested task groups, waited for depth first
+void ParallelQuicksort(int64_t* begin, int64_t* end) {
+  constexpr ptrdiff_t kSerialSize = 4096;
+  if (end - begin <= kSerialSize) {
+    std::sort(begin, end);
+    return;
+  }
+  int64_t pivot = begin[(end - begin) / 2];
+  int64_t* middle_begin = std::partition(begin, end, [pivot](int64_t x) { return x < pivot; });
+  int64_t* middle_end = std::partition(middle_begin, end,
+                                       [pivot](int64_t x) { return x == pivot; });
+  thread_pool::TaskGroup group;
+  group.Run([begin, middle_begin]() { ParallelQuicksort(begin, middle_begin); });
+  ParallelQuicksort(middle_end, end);
+  group.Wait();
+}
+
+int main() {
+  constexpr size_t kSize = 20000000;
+  std::mt19937_64 engine(50);
+  std::vector<int64_t> values(kSize);
+  for (int64_t& value : values) {
+    value = static_cast<int64_t>(engine() % 1000000);
+  }
+  std::cout << thread_pool::DefaultThreadPool().NumThreads() << " threads" << std::endl;
+
+  Timer timer;
+  int64_t serial_sum = 0;
+  for (int64_t value : values) {
+    serial_sum += value * value;
+  }
+  double serial_runtime = timer.GetSeconds();
+  timer.Reset();
+  int64_t sum = thread_pool::ParallelReduce(0, values.size(), 1 << 16, int64_t{0},
+      [&](size_t begin, size_t end) {
+        int64_t piece_sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+          piece_sum += values[i] * values[i];
+        }
+        return piece_sum;
+      }, [](int64_t left, int64_t right) { return left + right; });
+  double parallel_runtime = timer.GetSeconds();
+  std::cout << "Sum of squares: " << sum << (sum == serial_sum ? "" : " (WRONG)") << ", serial "
+            << serial_runtime << " s, ParallelReduce " << parallel_runtime << " s" << std::endl;
+
+  std::vector<int64_t> sorted = values;
+  timer.Reset();
+  std::sort(sorted.begin(), sorted.end());
+  double std_sort_runtime = timer.GetSeconds();
+  timer.Reset();
+  ParallelQuicksort(values.data(), values.data() + values.size());
+  double quicksort_runtime = timer.GetSeconds();
+  std::cout << "Sort: " << (values == sorted ? "" : "(WRONG) ") << "std::sort "
+            << std_sort_runtime << " s, ParallelQuicksort " << quicksort_runtime << " s"
+            << std::endl;
+  return 0;
+}
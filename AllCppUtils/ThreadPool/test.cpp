@@ -0,0 +1,210 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+
+int num_failures = 0;
+
+void Check(bool ok, const std::string& what) {
+  if (!ok) {
+    std::cout << "FAILED: " << what << std::endl;
+    ++num_failures;
+  }
+}
+
+// Every index is visited exactly once, for sizes around the grain
+void TestParallelFor(thread_pool::ThreadPool& pool) {
+  for (size_t size : {size_t{0}, size_t{1}, size_t{7}, size_t{1000}, size_t{100003}}) {
+    for (size_t grain : {size_t{0}, size_t{1}, size_t{16}, size_t{5000}}) {
+      std::vector<std::atomic<int>> visits(size + 10);
+      thread_pool::ParallelFor(10, size + 10, grain, [&](size_t i) { ++visits[i]; }, pool);
+      bool ok = true;
+      for (size_t i = 0; i < visits.size(); ++i) {
+        ok = ok && visits[i].load() == (i >= 10 ? 1 : 0);
+      }
+      Check(ok, "ParallelFor size " + std::to_string(size) + " grain " + std::to_string(grain));
+    }
+  }
+}
+
+// Sums in pieces of the grain, so the double result does not depend on the thread count
+double ReduceSum(const std::vector<double>& values, thread_pool::ThreadPool& pool) {
+  return thread_pool::ParallelReduce(0, values.size(), 1000, 0.0, [&](size_t begin, size_t end) {
+    double sum = 0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += values[i];
+    }
+    return sum;
+  }, [](double left, double right) { return left + right; }, pool);
+}
+
+uint64_t Fibonacci(int n, thread_pool::ThreadPool& pool) {
+  if (n < 2) {
+    return static_cast<uint64_t>(n);
+  }
+  uint64_t left = 0;
+  thread_pool::TaskGroup group(pool);
+  group.Run([&]() { left = Fibonacci(n - 1, pool); });
+  uint64_t right = Fibonacci(n - 2, pool);
+  group.Wait();
+  return left + right;
+}
+
+void TestPool(size_t num_threads) {
+  thread_pool::ThreadPool pool(num_threads);
+  std::string suffix = " (" + std::to_string(num_threads) + " threads)";
+  Check(pool.NumThreads() == num_threads, "NumThreads" + suffix);
+  TestParallelFor(pool);
+
+  std::vector<double> values(123457);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 1.0 / static_cast<double>(i + 1) * (i % 2 ? -1 : 1);
+  }
+  thread_pool::ThreadPool serial_pool(1);
+  Check(ReduceSum(values, pool) == ReduceSum(values, serial_pool), "ParallelReduce" + suffix);
+  int64_t int_sum = thread_pool::ParallelReduce(size_t{1}, size_t{100001}, 64, int64_t{0},
+      [](size_t begin, size_t end) {
+        int64_t sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+          sum += static_cast<int64_t>(i);
+        }
+        return sum;
+      }, [](int64_t left, int64_t right) { return left + right; }, pool);
+  Check(int_sum == int64_t{100000} * 100001 / 2, "ParallelReduce int" + suffix);
+
+  // Nested task groups: waiting threads run other tasks, so this cannot deadlock
+  Check(Fibonacci(20, pool) == 6765, "nested TaskGroups" + suffix);
+
+  // Nested ParallelFor
+  std::atomic<size_t> num_inner(0);
+  thread_pool::ParallelFor(0, 50, 1, [&](size_t) {
+    thread_pool::ParallelFor(0, 40, 3, [&](size_t) { ++num_inner; }, pool);
+  }, pool);
+  Check(num_inner.load() == 2000, "nested ParallelFor" + suffix);
+
+  // The first exception is rethrown by Wait once every task has finished, and the group can be
+  // used again afterwards
+  thread_pool::TaskGroup group(pool);
+  std::atomic<int> num_run(0);
+  for (int i = 0; i < 100; ++i) {
+    group.Run([&num_run, i]() {
+      ++num_run;
+      if (i % 10 == 3) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  }
+  bool thrown = false;
+  try {
+    group.Wait();
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  Check(thrown && num_run.load() == 100, "TaskGroup exception" + suffix);
+  group.Run([&num_run]() { ++num_run; });
+  group.Wait();
+  Check(num_run.load() == 101, "TaskGroup reuse" + suffix);
+
+  // A function that throws when Run copies it is never queued, so Wait does not hang on it
+  struct ThrowingCopy {
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy&) { throw std::runtime_error("copy failed"); }
+    void operator()() const {}
+  };
+  ThrowingCopy throwing_copy;
+  bool run_thrown = false;
+  try {
+    group.Run(throwing_copy);
+  } catch (const std::runtime_error&) {
+    run_thrown = true;
+  }
+  group.Wait();
+  Check(run_thrown, "TaskGroup::Run with a throwing copy" + suffix);
+
+  // Several outside threads using the pool at once
+  std::vector<std::thread> clients;
+  std::atomic<size_t> client_total(0);
+  for (int client = 0; client < 4; ++client) {
+    clients.emplace_back([&]() {
+      for (int round = 0; round < 20; ++round) {
+        thread_pool::ParallelFor(0, 1000, 10, [&](size_t) { ++client_total; }, pool);
+      }
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  Check(client_total.load() == 4 * 20 * 1000, "concurrent clients" + suffix);
+}
+
+// Owner pushes and pops while thieves steal: every task is taken exactly once
+void TestDeque() {
+  constexpr size_t kNumTasks = 200000;
+  struct NoopTask : thread_pool::internal::Task {
+    void Run() override {}
+  };
+  std::vector<NoopTask> tasks(kNumTasks);
+  std::vector<std::atomic<int>> taken(kNumTasks);
+  thread_pool::internal::WorkStealingDeque deque;
+  auto take = [&](thread_pool::internal::Task* task) {
+    ++taken[static_cast<NoopTask*>(task) - tasks.data()];
+  };
+  std::atomic<bool> done(false);
+  std::vector<std::thread> thieves;
+  for (int thief = 0; thief < 3; ++thief) {
+    thieves.emplace_back([&]() {
+      while (!done.load()) {
+        if (thread_pool::internal::Task* task = deque.Steal()) {
+          take(task);
+        }
+      }
+    });
+  }
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    deque.Push(&tasks[i]);
+    // Pop some back, and let the deque grow past its initial capacity now and then
+    if (i % 3 == 0 && i % 1000 < 900) {
+      if (thread_pool::internal::Task* task = deque.Pop()) {
+        take(task);
+      }
+    }
+  }
+  while (thread_pool::internal::Task* task = deque.Pop()) {
+    take(task);
+  }
+  done = true;
+  for (std::thread& thief : thieves) {
+    thief.join();
+  }
+  bool ok = true;
+  for (std::atomic<int>& count : taken) {
+    ok = ok && count.load() == 1;
+  }
+  Check(ok, "WorkStealingDeque push / pop / steal");
+}
+
+int main() {
+  TestDeque();
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    TestPool(num_threads);
+  }
+  thread_pool::Options pinned;
+  pinned.num_threads = 3;
+  pinned.pin_threads = true;
+  thread_pool::ThreadPool pinned_pool(pinned);
+  std::atomic<int> num_pinned_runs(0);
+  thread_pool::ParallelFor(0, 1000, 1, [&](size_t) { ++num_pinned_runs; }, pinned_pool);
+  Check(num_pinned_runs.load() == 1000, "pinned pool");
+  // The default pool, as used by the parallel utilities
+  std::atomic<int> num_default_runs(0);
+  thread_pool::ParallelFor(0, 1000, 1, [&](size_t) { ++num_default_runs; });
+  Check(num_default_runs.load() == 1000, "default pool");
+
+  std::cout << (num_failures == 0 ? "All tests passed" : "Tests FAILED") << std::endl;
+  return num_failures == 0 ? 0 : 1;
+}
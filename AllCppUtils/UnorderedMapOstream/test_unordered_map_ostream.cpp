@@ -1,6 +1,8 @@
 #include "unordered_map_ostream.hpp"
+#include "unordered_map_ostream.hpp"  // Included twice on purpose, the header is guarded
 
 #include <iostream>
+#include <string>
 #include <unordered_map>
 
 int main() {
@@ -16,5 +18,15 @@ int main() {
   map[11] = 11.6;
   std::cout << map << std::endl;
   
+  std::cout << std::endl;
+  std::cout << "Sorted by key: " << SortedByKey(map) << std::endl;
+  std::cout << "Top 3 by value: " << TopByValue(map, 3) << std::endl;
+  std::cout << "Top 10 by value: " << TopByValue(map, 10) << std::endl;
+  
+  std::unordered_map<std::string, int> word_counts{{"the", 12}, {"a", 12}, {"cat", 3}, {"sat", 5}};
+  std::cout << SortedByKey(word_counts) << std::endl;
+  std::cout << TopByValue(word_counts, 2) << std::endl;
+  std::cout << SortedByKey(std::unordered_map<int, int>()) << std::endl;
+  
   return 0;
 }
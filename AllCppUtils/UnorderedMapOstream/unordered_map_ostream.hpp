@@ -1,17 +1,158 @@
+#ifndef UNORDERED_MAP_OSTREAM_HPP
+#define UNORDERED_MAP_OSTREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <ostream>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
+
+#include "../common/container_format.hpp"
+#include "../common/fast_writer.hpp"
+
+// Maps are formatted by container_format like every other container: {k: v, ...}, with string
+// keys and values quoted
+template <typename K, typename V, typename H, typename E, typename A>
+std::ostream& operator<<(std::ostream& os, const std::unordered_map<K, V, H, E, A>& map) {
+  return container_format::WriteToStream(os, map);
+}
+
+// FastWriter version, for dumping large maps
+template <typename K, typename V, typename H, typename E, typename A>
+FastWriter& operator<<(FastWriter& writer, const std::unordered_map<K, V, H, E, A>& map) {
+  return container_format::WriteToWriter(writer, map);
+}
+
+// Map-like range over pointers to map entries, so a sorted or selected subset of a map is
+// formatted exactly like the map itself without copying keys or values
+template <typename Entry>
+class EntryPointerView {
+ public:
+  using key_type = typename std::remove_const<typename Entry::first_type>::type;
+  using mapped_type = typename Entry::second_type;
+
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = const Entry&;
+
+    explicit Iterator(const Entry* const* ptr) : ptr_(ptr) {}
+    const Entry& operator*() const { return **ptr_; }
+    const Entry* operator->() const { return *ptr_; }
+    Iterator& operator++() {
+      ++ptr_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++ptr_;
+      return old;
+    }
+    bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
+    bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
+
+   private:
+    const Entry* const* ptr_;
+  };
+
+  explicit EntryPointerView(const std::vector<const Entry*>& entries) : entries_(entries) {}
+
+  Iterator begin() const { return Iterator(entries_.data()); }
+  Iterator end() const { return Iterator(entries_.data() + entries_.size()); }
+
+ private:
+  const std::vector<const Entry*>& entries_;
+};
+
+// Writes entries as a map, works with std::ostream and FastWriter
+template <typename Entry>
+std::ostream& WriteMapEntries(std::ostream& os, const std::vector<const Entry*>& entries) {
+  return container_format::WriteToStream(os, EntryPointerView<Entry>(entries));
+}
+
+template <typename Entry>
+FastWriter& WriteMapEntries(FastWriter& writer, const std::vector<const Entry*>& entries) {
+  return container_format::WriteToWriter(writer, EntryPointerView<Entry>(entries));
+}
+
+// Prints the map ordered by key, so dumps from different hosts/runs can be diffed.
+// Only pointers to the entries are sorted, keys and values are never copied.
+template <typename Map>
+struct SortedByKeyView {
+  const Map& map;
 
-template <typename K, typename V>
-std::ostream& operator<<(std::ostream& os, const std::unordered_map<K, V>& map) {
-  os << "{ ";
-  size_t count = 0;
-  for (const std::pair<K, V>& item : map) {
-    os << item.first << ": " << item.second;
-    if (count + 1 < map.size()) {
-      os << ", ";
+  std::vector<const typename Map::value_type*> SortedEntries() const {
+    std::vector<const typename Map::value_type*> entries;
+    entries.reserve(map.size());
+    for (const typename Map::value_type& item : map) {
+      entries.push_back(&item);
     }
-    ++count;
+    std::sort(entries.begin(), entries.end(), [](const auto* left, const auto* right) {
+      return left->first < right->first;
+    });
+    return entries;
   }
-  os << " }";
-  return os;
+};
+
+template <typename Map>
+SortedByKeyView<Map> SortedByKey(const Map& map) {
+  return SortedByKeyView<Map>{map};
+}
+
+// Prints the num_entries entries with the largest values, largest first (ties ordered by key).
+// Uses partial selection over entry pointers: O(n + k log k), no key/value copies.
+template <typename Map>
+struct TopByValueView {
+  const Map& map;
+  size_t num_entries;
+
+  std::vector<const typename Map::value_type*> TopEntries() const {
+    std::vector<const typename Map::value_type*> entries;
+    entries.reserve(map.size());
+    for (const typename Map::value_type& item : map) {
+      entries.push_back(&item);
+    }
+    auto larger = [](const auto* left, const auto* right) {
+      if (right->second < left->second) return true;
+      if (left->second < right->second) return false;
+      return left->first < right->first;
+    };
+    size_t count = std::min(num_entries, entries.size());
+    std::nth_element(entries.begin(), entries.begin() + count, entries.end(), larger);
+    entries.resize(count);
+    std::sort(entries.begin(), entries.end(), larger);
+    return entries;
+  }
+};
+
+template <typename Map>
+TopByValueView<Map> TopByValue(const Map& map, size_t num_entries) {
+  return TopByValueView<Map>{map, num_entries};
 }
+
+template <typename Map>
+std::ostream& operator<<(std::ostream& os, const SortedByKeyView<Map>& view) {
+  return WriteMapEntries(os, view.SortedEntries());
+}
+
+template <typename Map>
+FastWriter& operator<<(FastWriter& writer, const SortedByKeyView<Map>& view) {
+  return WriteMapEntries(writer, view.SortedEntries());
+}
+
+template <typename Map>
+std::ostream& operator<<(std::ostream& os, const TopByValueView<Map>& view) {
+  return WriteMapEntries(os, view.TopEntries());
+}
+
+template <typename Map>
+FastWriter& operator<<(FastWriter& writer, const TopByValueView<Map>& view) {
+  return WriteMapEntries(writer, view.TopEntries());
+}
+
+#endif  // UNORDERED_MAP_OSTREAM_HPP
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/timer.hpp"
+#include "../common/vector_ostream.hpp"
+#include "vector_concat.hpp"
+
+// README version: moves element by element, then frees the source buffer
+template <typename T>
+void VectorJoin(std::vector<T>& primary_vector, std::vector<T>& other_vector) {
+  primary_vector.insert(primary_vector.end(),
+                        std::make_move_iterator(other_vector.begin()),
+                        std::make_move_iterator(other_vector.end()));
+  other_vector = {};
+}
+
+int main() {
+  std::vector<std::string> words{"alpha", "beta"};
+  std::vector<std::string> more_words{"gamma", "delta"};
+  VectorAppend(words, std::move(more_words));
+  std::cout << words << " " << more_words << std::endl;
+  VectorAppend(words, words);
+  std::cout << words << std::endl;
+
+  std::vector<int> a{1, 2};
+  std::vector<int> b{3};
+  std::vector<int> c{4, 5, 6};
+  std::cout << VectorConcat(a, b, std::move(c)) << " " << a << " " << c << std::endl;
+
+  // An empty destination takes over the source's buffer
+  std::vector<int> empty;
+  std::vector<int> source{7, 8, 9};
+  const int* source_data = source.data();
+  VectorAppend(empty, std::move(source));
+  std::cout << empty << (empty.data() == source_data ? " (buffer taken over)" : "") << std::endl;
+  std::cout << std::endl;
+
+  // Merging per-thread results: 8 vectors of 4 * 10^6 elements
+  constexpr size_t kNumParts = 8;
+  constexpr size_t kPartSize = 4000000;
+  auto make_parts = [&]() {
+    std::vector<std::vector<uint64_t>> parts(kNumParts);
+    for (size_t part_i = 0; part_i < kNumParts; ++part_i) {
+      parts[part_i].resize(kPartSize);
+      for (size_t i = 0; i < kPartSize; ++i) {
+        parts[part_i][i] = part_i * kPartSize + i;
+      }
+    }
+    return parts;
+  };
+  auto is_iota = [](const std::vector<uint64_t>& merged) {
+    for (size_t i = 0; i < merged.size(); ++i) {
+      if (merged[i] != i) {
+        return false;
+      }
+    }
+    return merged.size() == kNumParts * kPartSize;
+  };
+  Timer timer;
+
+  std::vector<std::vector<uint64_t>> parts = make_parts();
+  timer.Reset();
+  std::vector<uint64_t> joined;
+  for (std::vector<uint64_t>& part : parts) {
+    VectorJoin(joined, part);
+  }
+  double join_runtime = timer.GetSeconds();
+  std::cout << "VectorJoin one by one: " << join_runtime << " s"
+            << (is_iota(joined) ? "" : " (wrong result!)") << std::endl;
+
+  parts = make_parts();
+  timer.Reset();
+  std::vector<uint64_t> appended;
+  size_t total_size = kNumParts * kPartSize;
+  appended.reserve(total_size);
+  for (std::vector<uint64_t>& part : parts) {
+    VectorAppend(appended, std::move(part));
+  }
+  double append_runtime = timer.GetSeconds();
+  std::cout << "VectorAppend into reserved: " << append_runtime << " s"
+            << (is_iota(appended) ? "" : " (wrong result!)") << std::endl;
+
+  parts = make_parts();
+  timer.Reset();
+  std::vector<uint64_t> concatenated = ParallelVectorConcat(parts);
+  double parallel_runtime = timer.GetSeconds();
+  std::cout << "ParallelVectorConcat: " << parallel_runtime << " s"
+            << (is_iota(concatenated) ? "" : " (wrong result!)") << std::endl;
+
+  // With room reserved in the first part, only the others are copied
+  parts = make_parts();
+  parts[0].reserve(total_size);
+  timer.Reset();
+  concatenated = ParallelVectorConcat(parts);
+  parallel_runtime = timer.GetSeconds();
+  std::cout << "ParallelVectorConcat into reserved first part: " << parallel_runtime << " s"
+            << (is_iota(concatenated) ? "" : " (wrong result!)") << std::endl;
+  return 0;
+}
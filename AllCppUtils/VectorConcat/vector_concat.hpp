@@ -0,0 +1,167 @@
+#ifndef VECTOR_CONCAT_HPP
+#define VECTOR_CONCAT_HPP
+
+#include <algorithm>
+#include <cstring> // std::memcpy
+#include <iterator>
+#include <type_traits>
+#include <utility> // std::move, std::forward
+#include <vector>
+
+#include "../common/thread_pool.hpp"
+
+namespace vector_concat_internal {
+
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T, typename Allocator>
+struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+template <typename T>
+using RemoveCvRef = std::remove_cv_t<std::remove_reference_t<T>>;
+
+// Copies count elements over already constructed ones, as one block when T allows it
+template <typename T>
+void RelocateInto(T* destination, T* source, size_t count) {
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    if (count > 0) {
+      std::memcpy(destination, source, count * sizeof(T));
+    }
+  } else {
+    std::move(source, source + count, destination);
+  }
+}
+
+}  // namespace vector_concat_internal
+
+// Moves the elements of source to the back of destination and leaves source empty. Unlike
+// insert with make_move_iterator followed by source = {}:
+//  - an empty destination takes over source's buffer when it is at least as large, no copy;
+//  - trivially copyable elements are copied as one block (vector::insert from a pointer range
+//    is a memmove for them);
+//  - source keeps its capacity, so a per-thread buffer can be refilled without reallocating.
+template <typename T, typename Allocator>
+void VectorAppend(std::vector<T, Allocator>& destination, std::vector<T, Allocator>&& source) {
+  if (&destination == &source) {
+    return;
+  }
+  if (destination.empty() && source.capacity() >= destination.capacity()) {
+    destination.swap(source);
+    source.clear();
+    return;
+  }
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    destination.insert(destination.end(), source.data(), source.data() + source.size());
+  } else {
+    destination.insert(destination.end(), std::make_move_iterator(source.begin()),
+                       std::make_move_iterator(source.end()));
+  }
+  source.clear();
+}
+
+// Copies the elements of source to the back of destination, source may be destination itself
+template <typename T, typename Allocator>
+void VectorAppend(std::vector<T, Allocator>& destination,
+                  const std::vector<T, Allocator>& source) {
+  if (&destination == &source) {
+    size_t size = destination.size();
+    destination.reserve(2 * size);  // no reallocation below, so the elements read stay valid
+    std::copy_n(destination.begin(), size, std::back_inserter(destination));
+    return;
+  }
+  destination.insert(destination.end(), source.begin(), source.end());
+}
+
+// Concatenates any number of vectors of the same type into a new one, allocating once: lvalues
+// are copied, rvalues moved (and left empty). If the first vector is an rvalue with enough
+// capacity for everything, the result takes over its buffer.
+//
+//   std::vector<int> all = VectorConcat(std::move(first), second, std::move(third));
+template <typename First, typename... Rest>
+vector_concat_internal::RemoveCvRef<First> VectorConcat(First&& first, Rest&&... rest) {
+  using Vector = vector_concat_internal::RemoveCvRef<First>;
+  static_assert(vector_concat_internal::IsVector<Vector>::value, "std::vector arguments required");
+  static_assert((std::is_same<Vector, vector_concat_internal::RemoveCvRef<Rest>>::value && ...),
+                "All arguments must be the same std::vector type");
+  size_t total_size = first.size() + (size_t{0} + ... + rest.size());
+  Vector result;
+  if constexpr (!std::is_lvalue_reference<First>::value) {
+    if (first.capacity() >= total_size) {
+      result.swap(first);
+    }
+  }
+  if (result.capacity() < total_size) {
+    result.reserve(total_size);
+    VectorAppend(result, std::forward<First>(first));
+  }
+  (VectorAppend(result, std::forward<Rest>(rest)), ...);
+  return result;
+}
+
+// Concatenates sources in order on num_threads threads (0 means one per pool thread) and
+// leaves every source empty with its capacity kept, for merging large per-thread results. The
+// output is split into equal slices and each thread copies (or moves) the parts of the sources
+// that fall in its slice. Needs default constructible elements, the result is sized before
+// the threads fill it; if sources[0] has capacity for everything it becomes the result.
+template <typename T, typename Allocator>
+std::vector<T, Allocator> ParallelVectorConcat(std::vector<std::vector<T, Allocator>>& sources,
+                                               size_t num_threads = 0) {
+  // Below this many bytes per thread, waking a pool thread costs more than the copy it saves
+  constexpr size_t kMinBytesPerThread = size_t{1} << 20;
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  std::vector<T, Allocator> result;
+  if (sources.empty()) {
+    return result;
+  }
+  size_t total_size = 0;
+  for (const std::vector<T, Allocator>& source : sources) {
+    total_size += source.size();
+  }
+  // Output offset of each source, the first one may already be in place
+  size_t first_source = 0;
+  size_t done_size = 0;
+  if (sources[0].capacity() >= total_size) {
+    result.swap(sources[0]);
+    first_source = 1;
+    done_size = result.size();
+  } else {
+    result.reserve(total_size);
+  }
+  result.resize(total_size);
+  std::vector<size_t> offsets(sources.size() + 1, done_size);
+  for (size_t i = first_source; i < sources.size(); ++i) {
+    offsets[i + 1] = offsets[i] + sources[i].size();
+  }
+
+  size_t copy_size = total_size - done_size;
+  num_threads = std::min(num_threads,
+                         std::max<size_t>(1, copy_size * sizeof(T) / kMinBytesPerThread));
+  // Output slice [begin, end) gathers the overlapping parts of the sources
+  auto copy_slice = [&](size_t begin, size_t end) {
+    size_t source_i = std::upper_bound(offsets.begin() + first_source + 1, offsets.end(), begin) -
+                      offsets.begin() - 1;
+    for (; source_i < sources.size() && offsets[source_i] < end; ++source_i) {
+      size_t part_begin = std::max(begin, offsets[source_i]);
+      size_t part_end = std::min(end, offsets[source_i + 1]);
+      T* source_data = sources[source_i].data() + (part_begin - offsets[source_i]);
+      vector_concat_internal::RelocateInto(result.data() + part_begin, source_data,
+                                           part_end - part_begin);
+    }
+  };
+  if (num_threads == 1) {
+    copy_slice(done_size, total_size);
+  } else {
+    thread_pool::ParallelFor(0, num_threads, 1, [&](size_t thread_i) {
+      copy_slice(done_size + copy_size * thread_i / num_threads,
+                 done_size + copy_size * (thread_i + 1) / num_threads);
+    });
+  }
+  for (size_t i = first_source; i < sources.size(); ++i) {
+    sources[i].clear();
+  }
+  return result;
+}
+
+#endif  // VECTOR_CONCAT_HPP
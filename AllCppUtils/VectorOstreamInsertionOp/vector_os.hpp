@@ -1,15 +1,9 @@
 #include <ostream>
 #include <vector>
 
+#include "../common/container_format.hpp"
+
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
-  os << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    os << v[i];
-    if (i + 1 < v.size()) {
-      os << ", ";
-    }
-  }
-  os << (v.size() ? "]" : " ]");
-  return os;
+  return container_format::WriteToStream(os, v);
 }
@@ -2,41 +2,31 @@
 #define VECTOR_OSTREAM_HPP
 
 #include <ostream>
-#include <string>
 #include <utility>
 #include <vector>
 
+#include "container_format.hpp"
+#include "fast_writer.hpp"
+
 template <typename T1, typename T2>
 std::ostream& operator<<(std::ostream& os, const std::pair<T1, T2>& p) {
-  os << "(" << p.first << ", " << p.second << ")";
-  return os;
+  return container_format::WriteToStream(os, p);
+}
+
+template <typename T1, typename T2>
+FastWriter& operator<<(FastWriter& writer, const std::pair<T1, T2>& p) {
+  return container_format::WriteToWriter(writer, p);
 }
 
+// Elements are formatted by container_format, so nested containers, pairs and strings work too
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
-  os << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    os << v[i];
-    if (i + 1 < v.size()) {
-      os << ", ";
-    }
-  }
-  os << (v.size() ? "]" : " ]");
-  return os;
+  return container_format::WriteToStream(os, v);
 }
 
-// Specialization for vector of strings
-std::ostream& operator<<(std::ostream& os, const std::vector<std::string>& v) {
-  os << "[";
-  for (size_t i = 0; i < v.size(); ++i) {
-    os << "\"" << v[i] << "\"";
-    if (i + 1 < v.size()) {
-      os << ", ";
-    }
-  }
-  os << "]";
-  return os;
+template <typename T>
+FastWriter& operator<<(FastWriter& writer, const std::vector<T>& v) {
+  return container_format::WriteToWriter(writer, v);
 }
 
 #endif  // VECTOR_OSTREAM_HPP
-
@@ -0,0 +1 @@
+#include "../../headers/container_format.hpp"
@@ -0,0 +1 @@
+#include "../../headers/fast_writer.hpp"
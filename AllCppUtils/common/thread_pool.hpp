@@ -0,0 +1 @@
+#include "../../headers/thread_pool.hpp"
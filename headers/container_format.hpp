@@ -0,0 +1,511 @@
+#ifndef CONTAINER_FORMAT_HPP
+#define CONTAINER_FORMAT_HPP
+
+#include <algorithm>
+#include <charconv> // std::to_chars
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "fast_writer.hpp"
+
+// Single formatter for ranges, maps, sets, pairs/tuples, optionals and variants, nested to any
+// depth. The layout is picked at compile time from the type:
+//   ranges [a, b]   maps {k: v}   sets {a, b}   tuples (a, b)   optionals value or nullopt
+// Strings nested inside containers are quoted, leaves are written with std::to_chars, and types
+// the formatter does not know fall back to their own operator<<.
+namespace container_format {
+
+// Format spec for leaf values, a subset of std::format's:
+//   [[fill]align][sign][0][width][.precision][type]
+struct LeafSpec {
+  char fill = ' ';
+  char align = '\0';  // '<', '>', '^', or '=' (pad after the sign, from the '0' flag)
+  char sign = '-';  // '-' or '+'
+  int width = 0;
+  int precision = -1;
+  // Integers: d x X o b; floats: f e g (none = shortest round-trip);
+  // s: strings are cut to precision
+  char type = '\0';
+};
+
+struct FormatOptions {
+  LeafSpec leaf;
+  // Ranges with more than head + tail elements print the first head and last tail elements
+  // around "...", unless truncate is false
+  bool truncate = false;
+  size_t head = 8;
+  size_t tail = 2;
+  bool bool_alpha = true;  // true/false rather than 1/0
+  // When set, numbers are written with this stream's flags (hex, showpoint, uppercase, ...)
+  // instead of leaf, for stream states a LeafSpec cannot express
+  const std::ostream* leaf_stream = nullptr;
+};
+
+// Parses a std::format style spec, optionally wrapped in "{:...}", followed by an optional
+// truncation suffix "|head..tail". For example "{:>8.3f|8..2}". Throws std::invalid_argument.
+inline FormatOptions ParseFormatSpec(std::string_view spec) {
+  FormatOptions options;
+  if (spec.size() >= 2 && spec.front() == '{' && spec.back() == '}') {
+    spec = spec.substr(1, spec.size() - 2);
+    if (!spec.empty() && spec.front() == ':') {
+      spec.remove_prefix(1);
+    }
+  }
+  size_t bar_i = spec.find('|');
+  if (bar_i != std::string_view::npos) {
+    std::string_view truncation = spec.substr(bar_i + 1);
+    size_t dots_i = truncation.find("..");
+    const char* end = truncation.data() + truncation.size();
+    if (dots_i == std::string_view::npos ||
+        std::from_chars(truncation.data(), truncation.data() + dots_i, options.head).ptr !=
+            truncation.data() + dots_i ||
+        std::from_chars(truncation.data() + dots_i + 2, end, options.tail).ptr != end) {
+      throw std::invalid_argument("Bad truncation spec: " + std::string(truncation));
+    }
+    options.truncate = true;
+    spec = spec.substr(0, bar_i);
+  }
+  LeafSpec& leaf = options.leaf;
+  auto is_align = [](char ch) { return ch == '<' || ch == '>' || ch == '^'; };
+  size_t i = 0;
+  if (spec.size() >= 2 && is_align(spec[1])) {
+    leaf.fill = spec[0];
+    leaf.align = spec[1];
+    i = 2;
+  } else if (!spec.empty() && is_align(spec[0])) {
+    leaf.align = spec[0];
+    i = 1;
+  }
+  if (i < spec.size() && (spec[i] == '+' || spec[i] == '-')) {
+    leaf.sign = spec[i++];
+  }
+  if (i < spec.size() && spec[i] == '0') {
+    if (leaf.align == '\0') {
+      leaf.fill = '0';
+      leaf.align = '=';
+    }
+    ++i;
+  }
+  const char* spec_end = spec.data() + spec.size();
+  i = std::from_chars(spec.data() + i, spec_end, leaf.width).ptr - spec.data();
+  if (i < spec.size() && spec[i] == '.') {
+    const char* precision_end =
+        std::from_chars(spec.data() + i + 1, spec_end, leaf.precision).ptr;
+    if (precision_end == spec.data() + i + 1) {
+      throw std::invalid_argument("Missing precision in format spec: " + std::string(spec));
+    }
+    i = precision_end - spec.data();
+  }
+  if (i < spec.size()) {
+    leaf.type = spec[i++];
+    if (std::string_view("dxXobfegs").find(leaf.type) == std::string_view::npos) {
+      throw std::invalid_argument("Unknown format type: " + std::string(1, leaf.type));
+    }
+  }
+  if (i != spec.size()) {
+    throw std::invalid_argument("Bad format spec: " + std::string(spec));
+  }
+  return options;
+}
+
+// Output sinks: anything with a SinkWrite overload can be formatted into
+inline void SinkWrite(std::string& sink, const char* data, size_t length) {
+  sink.append(data, length);
+}
+
+inline void SinkWrite(FastWriter& sink, const char* data, size_t length) {
+  sink.Write(data, length);
+}
+
+inline void SinkWrite(std::ostream& sink, const char* data, size_t length) {
+  sink.write(data, static_cast<std::streamsize>(length));
+}
+
+namespace internal {
+
+template <typename T, typename = void>
+struct IsRange : std::false_type {};
+template <typename T>
+struct IsRange<T, std::void_t<decltype(std::begin(std::declval<const T&>())),
+                              decltype(std::end(std::declval<const T&>()))>> : std::true_type {};
+
+template <typename T, typename = void>
+struct IsMapLike : std::false_type {};
+template <typename T>
+struct IsMapLike<T, std::void_t<typename T::key_type, typename T::mapped_type>> :
+    IsRange<T> {};
+
+template <typename T, typename = void>
+struct IsSetLike : std::false_type {};
+template <typename T>
+struct IsSetLike<T, std::void_t<typename T::key_type>> :
+    std::integral_constant<bool, IsRange<T>::value && !IsMapLike<T>::value> {};
+
+template <typename T, typename = void>
+struct IsTupleLike : std::false_type {};
+template <typename T>
+struct IsTupleLike<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {};
+
+template <typename T>
+struct IsOptional : std::false_type {};
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+struct IsVariant : std::false_type {};
+template <typename... Ts>
+struct IsVariant<std::variant<Ts...>> : std::true_type {};
+
+template <typename T, typename = void>
+struct IsOstreamable : std::false_type {};
+template <typename T>
+struct IsOstreamable<T, std::void_t<decltype(std::declval<std::ostream&>() <<
+                                             std::declval<const T&>())>> : std::true_type {};
+
+template <typename T>
+struct IsStringLike : std::is_convertible<const T&, std::string_view> {};
+
+// Enough for a 64-bit integer in binary or the shortest form of any double
+constexpr size_t kLeafBufferSize = 128;
+
+template <typename T, typename = void>
+struct HasSize : std::false_type {};
+template <typename T>
+struct HasSize<T, std::void_t<decltype(std::declval<const T&>().size())>> : std::true_type {};
+
+// O(1) for arrays and containers with size(), a walk over the range otherwise
+template <typename Range>
+size_t RangeSize(const Range& range) {
+  if constexpr (std::is_array<Range>::value) {
+    return std::extent<Range>::value;
+  } else if constexpr (HasSize<Range>::value) {
+    return static_cast<size_t>(range.size());
+  } else {
+    return static_cast<size_t>(std::distance(std::begin(range), std::end(range)));
+  }
+}
+
+template <typename Sink>
+class Formatter {
+ public:
+  Formatter(Sink& sink, const FormatOptions& options) : sink_(sink), options_(options) {}
+
+  template <typename T>
+  void Format(const T& value, int depth) {
+    if constexpr (IsStringLike<T>::value) {
+      FormatString(std::string_view(value), depth > 0);
+    } else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                         std::is_same<T, unsigned char>::value) {
+      // int8_t / uint8_t too, written as characters like std::ostream and FastWriter do
+      char ch = static_cast<char>(value);
+      WritePadded(&ch, 1);
+    } else if constexpr (std::is_same<T, bool>::value) {
+      if (options_.bool_alpha) {
+        WritePadded(value ? "true" : "false", value ? 4 : 5);
+      } else {
+        WritePadded(value ? "1" : "0", 1);
+      }
+    } else if constexpr (std::is_arithmetic<T>::value) {
+      if (options_.leaf_stream) {
+        FormatWithStream(value);
+      } else if constexpr (std::is_integral<T>::value) {
+        FormatInt(value);
+      } else {
+        FormatFloat(value);
+      }
+    } else if constexpr (IsOptional<T>::value) {
+      if (value) {
+        Format(*value, depth);
+      } else {
+        Write("nullopt");
+      }
+    } else if constexpr (IsVariant<T>::value) {
+      if (value.valueless_by_exception()) {
+        Write("valueless");
+      } else {
+        std::visit([this, depth](const auto& alternative) { Format(alternative, depth); }, value);
+      }
+    } else if constexpr (IsMapLike<T>::value) {
+      FormatRange(value, "{", "}", [this, depth](const auto& item) {
+        Format(item.first, depth + 1);
+        Write(": ");
+        Format(item.second, depth + 1);
+      });
+    } else if constexpr (IsRange<T>::value) {
+      const char* open = IsSetLike<T>::value ? "{" : "[";
+      const char* close = IsSetLike<T>::value ? "}" : "]";
+      FormatRange(value, open, close, [this, depth](const auto& item) {
+        Format(item, depth + 1);
+      });
+    } else if constexpr (IsTupleLike<T>::value) {
+      Write("(");
+      FormatTupleElements(value, depth, std::make_index_sequence<std::tuple_size<T>::value>());
+      Write(")");
+    } else {
+      static_assert(IsOstreamable<T>::value, "Type is not a container and has no operator<<");
+      std::ostringstream oss;
+      oss << value;
+      std::string s = oss.str();
+      WritePadded(s.data(), s.size());
+    }
+  }
+
+ private:
+  Sink& sink_;
+  const FormatOptions& options_;
+
+  void Write(std::string_view s) {
+    SinkWrite(sink_, s.data(), s.size());
+  }
+
+  void WriteFill(size_t count) {
+    char fill_chars[32];
+    std::fill_n(fill_chars, sizeof(fill_chars), options_.leaf.fill);
+    while (count > 0) {
+      size_t chunk = std::min(count, sizeof(fill_chars));
+      SinkWrite(sink_, fill_chars, chunk);
+      count -= chunk;
+    }
+  }
+
+  // Writes a formatted leaf, applying width, fill and alignment
+  void WritePadded(const char* data, size_t length, bool is_number = false) {
+    const LeafSpec& leaf = options_.leaf;
+    size_t width = static_cast<size_t>(std::max(leaf.width, 0));
+    if (length >= width) {
+      SinkWrite(sink_, data, length);
+      return;
+    }
+    size_t padding = width - length;
+    char align = leaf.align ? leaf.align : (is_number ? '>' : '<');
+    if (align == '=') {
+      if (length > 0 && (data[0] == '-' || data[0] == '+')) {
+        SinkWrite(sink_, data, 1);
+        ++data;
+        --length;
+      }
+      WriteFill(padding);
+      SinkWrite(sink_, data, length);
+    } else if (align == '<') {
+      SinkWrite(sink_, data, length);
+      WriteFill(padding);
+    } else if (align == '>') {
+      WriteFill(padding);
+      SinkWrite(sink_, data, length);
+    } else {
+      WriteFill(padding / 2);
+      SinkWrite(sink_, data, length);
+      WriteFill(padding - padding / 2);
+    }
+  }
+
+  void FormatString(std::string_view s, bool quoted) {
+    if (options_.leaf.type == 's' && options_.leaf.precision >= 0) {
+      s = s.substr(0, static_cast<size_t>(options_.leaf.precision));
+    }
+    if (!quoted) {
+      WritePadded(s.data(), s.size());
+      return;
+    }
+    Write("\"");
+    Write(s);
+    Write("\"");
+  }
+
+  // A number written like options_.leaf_stream would write it, without its width
+  template <typename T>
+  void FormatWithStream(T value) {
+    std::ostringstream oss;
+    oss.copyfmt(*options_.leaf_stream);
+    oss.width(0);
+    oss << value;
+    std::string s = oss.str();
+    WritePadded(s.data(), s.size(), true);
+  }
+
+  template <typename IntType>
+  void FormatInt(IntType value) {
+    char buffer[kLeafBufferSize];
+    char* begin = buffer + 1;  // Room for a '+' sign
+    int base = 10;
+    switch (options_.leaf.type) {
+      case 'x': case 'X': base = 16; break;
+      case 'o': base = 8; break;
+      case 'b': base = 2; break;
+      default: break;
+    }
+    char* end = std::to_chars(begin, buffer + kLeafBufferSize, value, base).ptr;
+    if (options_.leaf.type == 'X') {
+      for (char* ch = begin; ch != end; ++ch) {
+        *ch = (*ch >= 'a' && *ch <= 'f') ? static_cast<char>(*ch - 'a' + 'A') : *ch;
+      }
+    }
+    if (options_.leaf.sign == '+' && *begin != '-') {
+      *--begin = '+';
+    }
+    WritePadded(begin, static_cast<size_t>(end - begin), true);
+  }
+
+  template <typename FloatType>
+  void FormatFloat(FloatType value) {
+    const LeafSpec& leaf = options_.leaf;
+    char buffer[kLeafBufferSize];
+    char* begin = buffer + 1;  // Room for a '+' sign
+    std::chars_format format = std::chars_format::general;
+    if (leaf.type == 'f') {
+      format = std::chars_format::fixed;
+    } else if (leaf.type == 'e') {
+      format = std::chars_format::scientific;
+    }
+    std::to_chars_result result;
+    if (leaf.precision < 0 && leaf.type == '\0') {
+      result = std::to_chars(begin, buffer + kLeafBufferSize, value);
+    } else {
+      // Same default precision as std::format and printf
+      int precision = (leaf.precision < 0) ? 6 : leaf.precision;
+      result = std::to_chars(begin, buffer + kLeafBufferSize, value, format, precision);
+      if (result.ec == std::errc::value_too_large) {
+        // Huge fixed-point output, e.g. 1e300 with "f"
+        std::string large(static_cast<size_t>(precision) + 400, '\0');
+        large.resize(std::to_chars(&large[0], &large[0] + large.size(), value, format,
+                                   precision).ptr - &large[0]);
+        if (leaf.sign == '+' && large[0] != '-') {
+          large.insert(large.begin(), '+');
+        }
+        WritePadded(large.data(), large.size(), true);
+        return;
+      }
+    }
+    if (leaf.sign == '+' && *begin != '-') {
+      *--begin = '+';
+    }
+    WritePadded(begin, static_cast<size_t>(result.ptr - begin), true);
+  }
+
+  template <typename Range, typename FormatItem>
+  void FormatRange(const Range& range, const char* open, const char* close,
+                   FormatItem format_item) {
+    Write(open);
+    // Only counted when truncating, so untruncated lists and maps are walked once
+    size_t size = options_.truncate ? RangeSize(range) : 0;
+    bool truncate = options_.truncate && size > options_.head + options_.tail;
+    size_t i = 0;
+    for (auto it = std::begin(range); it != std::end(range); ++it, ++i) {
+      if (truncate && i == options_.head) {
+        Write(options_.head ? ", ..." : "...");
+        std::advance(it, size - options_.tail - options_.head);
+        i = size - options_.tail;
+        if (it == std::end(range)) {
+          break;
+        }
+      }
+      if (i > 0) {
+        Write(", ");
+      }
+      format_item(*it);
+    }
+    Write(close);
+  }
+
+  template <typename Tuple, size_t... Is>
+  void FormatTupleElements(const Tuple& tuple, int depth, std::index_sequence<Is...>) {
+    using std::get;
+    ((Is > 0 ? Write(", ") : void(), Format(get<Is>(tuple), depth + 1)), ...);
+  }
+};
+
+}  // namespace internal
+
+// Formats value into any sink (std::string, FastWriter, std::ostream)
+template <typename Sink, typename T>
+void FormatTo(Sink& sink, const T& value, const FormatOptions& options = FormatOptions()) {
+  internal::Formatter<Sink> formatter(sink, options);
+  formatter.Format(value, 0);
+}
+
+template <typename Sink, typename T>
+void FormatTo(Sink& sink, const T& value, std::string_view spec) {
+  FormatTo(sink, value, ParseFormatSpec(spec));
+}
+
+template <typename T>
+std::string Format(const T& value, const FormatOptions& options = FormatOptions()) {
+  std::string result;
+  FormatTo(result, value, options);
+  return result;
+}
+
+template <typename T>
+std::string Format(const T& value, std::string_view spec) {
+  return Format(value, ParseFormatSpec(spec));
+}
+
+// Options matching the stream's own state (precision, fixed/scientific, showpos, boolalpha).
+// Flags with no LeafSpec equivalent (hex/oct, showbase, showpoint, uppercase, hexfloat) make the
+// numbers go through the stream's own formatting instead.
+inline FormatOptions OptionsFromStream(const std::ostream& os) {
+  FormatOptions options;
+  std::ios_base::fmtflags flags = os.flags();
+  std::ios_base::fmtflags float_field = flags & std::ios_base::floatfield;
+  options.leaf.type = (float_field == std::ios_base::fixed) ? 'f' :
+                      (float_field == std::ios_base::scientific) ? 'e' : 'g';
+  options.leaf.precision = static_cast<int>(os.precision());
+  options.leaf.sign = (flags & std::ios_base::showpos) ? '+' : '-';
+  options.bool_alpha = (flags & std::ios_base::boolalpha) != 0;
+  std::ios_base::fmtflags base_field = flags & std::ios_base::basefield;
+  bool decimal = base_field == std::ios_base::dec || base_field == std::ios_base::fmtflags();
+  if (!decimal || float_field == (std::ios_base::fixed | std::ios_base::scientific) ||
+      (flags & (std::ios_base::showbase | std::ios_base::showpoint | std::ios_base::uppercase))) {
+    options.leaf_stream = &os;
+  }
+  return options;
+}
+
+// Options matching a FastWriter's float precision
+inline FormatOptions OptionsFromWriter(const FastWriter& writer) {
+  FormatOptions options;
+  if (writer.FloatPrecision() != FastWriter::kShortestFloat) {
+    options.leaf.type = 'g';
+    options.leaf.precision = writer.FloatPrecision();
+  }
+  options.bool_alpha = false;
+  return options;
+}
+
+// Formats into a local buffer, then hands the stream a single write. The stream's width applies
+// to the whole formatted value and is reset afterwards, like for any other operator<<.
+template <typename T>
+std::ostream& WriteToStream(std::ostream& os, const T& value) {
+  std::string buffer;
+  FormatTo(buffer, value, OptionsFromStream(os));
+  std::streamsize width = os.width();
+  os.width(0);
+  size_t padding = (width > 0 && static_cast<size_t>(width) > buffer.size()) ?
+      static_cast<size_t>(width) - buffer.size() : 0;
+  if (padding > 0 && (os.flags() & std::ios_base::adjustfield) != std::ios_base::left) {
+    buffer.insert(0, padding, os.fill());
+  } else if (padding > 0) {
+    buffer.append(padding, os.fill());
+  }
+  os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return os;
+}
+
+template <typename T>
+FastWriter& WriteToWriter(FastWriter& writer, const T& value) {
+  FormatTo(writer, value, OptionsFromWriter(writer));
+  return writer;
+}
+
+}  // namespace container_format
+
+#endif  // CONTAINER_FORMAT_HPP
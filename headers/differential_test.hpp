@@ -0,0 +1,284 @@
+#ifndef DIFFERENTIAL_TEST_HPP
+#define DIFFERENTIAL_TEST_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility> // std::move
+#include <vector>
+
+#include "container_format.hpp"
+#include "thread_pool.hpp"
+
+// Randomized differential testing: a reference (naive) and a candidate (optimized) solution are
+// run on generated inputs, spread over all cores. Every case draws from its own engine seeded
+// from (run seed, case index), so any failure is reproduced from the printed case seed alone,
+// independent of thread count or scheduling. Failing inputs are shrunk with delta debugging
+// before they are printed.
+//
+//   differential_test::Options options;
+//   options.num_cases = 100000000;
+//   differential_test::Run("MaxFlags", GenerateSignal, NaiveMaxFlags, MaxFlags, options);
+//
+// generate(engine) returns the input, a std::vector or std::string so it can be shrunk.
+// reference(input) and candidate(input) return results compared with ==; an exception thrown by
+// either also counts as a failure.
+namespace differential_test {
+
+// Small-state engine (SplitMix64), so seeding one per case costs nothing. Satisfies
+// UniformRandomBitGenerator, so it works with the <random> distributions.
+class Engine {
+ public:
+  using result_type = uint64_t;
+
+  explicit Engine(uint64_t seed) : state_(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+ private:
+  uint64_t state_;
+};
+
+// Seed of case case_index in the run with run_seed
+inline uint64_t CaseSeed(uint64_t run_seed, uint64_t case_index) {
+  Engine engine(run_seed ^ (case_index * 0xD1B54A32D192ED03ULL));
+  return engine();
+}
+
+struct Options {
+  uint64_t num_cases = 100000;
+  uint64_t seed = 1;  // run seed, change it to explore different cases
+  size_t num_threads = 0;  // 0 means one per thread of thread_pool::DefaultThreadPool()
+  size_t max_failures = 1;  // the run stops once this many failing cases are found
+  size_t max_shrink_checks = 100000;
+  // Printed inputs keep their first head and last tail elements
+  size_t print_head = 32;
+  size_t print_tail = 8;
+  bool verbose = true;
+};
+
+struct Failure {
+  uint64_t case_index;
+  uint64_t case_seed;
+};
+
+struct Result {
+  uint64_t num_cases_run = 0;
+  std::vector<Failure> failures;  // ordered by case index, at most max_failures
+
+  bool Passed() const { return failures.empty(); }
+};
+
+namespace internal {
+
+// Outcome of one side: either a value or the message of the exception it threw
+template <typename Function, typename Input>
+auto RunSide(Function& function, const Input& input, std::string& error) {
+  using ResultType = decltype(function(input));
+  try {
+    return ResultType(function(input));
+  } catch (const std::exception& exception) {
+    error = exception.what();
+  } catch (...) {
+    error = "unknown exception";
+  }
+  return ResultType();
+}
+
+template <typename Input, typename Reference, typename Candidate>
+bool CaseFails(const Input& input, Reference& reference, Candidate& candidate) {
+  std::string reference_error;
+  std::string candidate_error;
+  auto reference_result = RunSide(reference, input, reference_error);
+  auto candidate_result = RunSide(candidate, input, candidate_error);
+  return !reference_error.empty() || !candidate_error.empty() ||
+         !(reference_result == candidate_result);
+}
+
+// Delta debugging (ddmin): removes chunks of the input, halving the chunk size whenever no chunk
+// can be removed, until no single element can be removed and the case still fails. Needs
+// O(size^2) checks in the worst case and usually O(size log size).
+template <typename Input, typename Fails>
+Input Shrink(Input input, Fails fails, size_t max_checks, size_t& num_checks) {
+  num_checks = 0;
+  if (input.empty()) {
+    return input;
+  }
+  ++num_checks;
+  if (fails(Input())) {
+    return Input();
+  }
+  size_t num_chunks = 2;
+  while (input.size() >= 2 && num_checks < max_checks) {
+    num_chunks = std::min(num_chunks, input.size());
+    bool reduced = false;
+    for (size_t chunk_i = 0; chunk_i < num_chunks && num_checks < max_checks; ++chunk_i) {
+      size_t begin = input.size() * chunk_i / num_chunks;
+      size_t end = input.size() * (chunk_i + 1) / num_chunks;
+      // The complement of the chunk: removing it is the common success
+      Input complement(input.begin(), input.begin() + begin);
+      complement.insert(complement.end(), input.begin() + end, input.end());
+      ++num_checks;
+      if (fails(complement)) {
+        input = std::move(complement);
+        num_chunks = std::max<size_t>(num_chunks - 1, 2);
+        reduced = true;
+        break;
+      }
+      if (num_chunks > 2) {
+        Input chunk(input.begin() + begin, input.begin() + end);
+        ++num_checks;
+        if (fails(chunk)) {
+          input = std::move(chunk);
+          num_chunks = 2;
+          reduced = true;
+          break;
+        }
+      }
+    }
+    if (!reduced) {
+      if (num_chunks >= input.size()) {
+        break;
+      }
+      num_chunks = std::min(2 * num_chunks, input.size());
+    }
+  }
+  return input;
+}
+
+template <typename Input, typename Reference, typename Candidate>
+void PrintFailure(std::string_view name, const Failure& failure, const Input& original,
+                  const Input& shrunk, size_t num_checks, Reference& reference,
+                  Candidate& candidate, const Options& options) {
+  container_format::FormatOptions format_options;
+  format_options.truncate = true;
+  format_options.head = options.print_head;
+  format_options.tail = options.print_tail;
+  std::string reference_error;
+  std::string candidate_error;
+  auto reference_result = RunSide(reference, shrunk, reference_error);
+  auto candidate_result = RunSide(candidate, shrunk, candidate_error);
+  auto describe = [&](const auto& side_result, const std::string& error) {
+    return error.empty() ? container_format::Format(side_result, format_options) : "threw " + error;
+  };
+  std::cout << "[" << name << "] FAILED case " << failure.case_index
+            << ", replay with case seed 0x" << std::hex << failure.case_seed << std::dec
+            << std::endl;
+  std::cout << "  input size " << original.size() << " shrunk to " << shrunk.size() << " in "
+            << num_checks << " checks: " << container_format::Format(shrunk, format_options)
+            << std::endl;
+  std::cout << "  reference: " << describe(reference_result, reference_error) << std::endl;
+  std::cout << "  candidate: " << describe(candidate_result, candidate_error) << std::endl;
+}
+
+}  // namespace internal
+
+// Regenerates, checks, shrinks and prints one case. Returns true if it passes.
+template <typename Generate, typename Reference, typename Candidate>
+bool ReplayCase(std::string_view name, uint64_t case_seed, Generate generate, Reference reference,
+                Candidate candidate, const Options& options = Options()) {
+  Engine engine(case_seed);
+  auto input = generate(engine);
+  if (!internal::CaseFails(input, reference, candidate)) {
+    std::cout << "[" << name << "] case seed 0x" << std::hex << case_seed << std::dec << " passes"
+              << std::endl;
+    return true;
+  }
+  size_t num_checks = 0;
+  auto shrunk = internal::Shrink(input, [&](const auto& smaller) {
+    return internal::CaseFails(smaller, reference, candidate);
+  }, options.max_shrink_checks, num_checks);
+  internal::PrintFailure(name, Failure{0, case_seed}, input, shrunk, num_checks, reference,
+                         candidate, options);
+  return false;
+}
+
+// Runs cases [0, num_cases) on num_threads threads. Threads take blocks of case indices from a
+// shared counter; once max_failures failing cases are found the remaining blocks are skipped,
+// and the failures with the lowest case indices found are shrunk and printed.
+template <typename Generate, typename Reference, typename Candidate>
+Result Run(std::string_view name, Generate generate, Reference reference, Candidate candidate,
+           const Options& options = Options()) {
+  constexpr uint64_t kBlockSize = 256;
+  size_t num_threads = options.num_threads;
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  auto start_time = std::chrono::steady_clock::now();
+  std::atomic<uint64_t> next_case(0);
+  std::atomic<uint64_t> num_cases_run(0);
+  std::atomic<size_t> num_failures(0);
+  std::mutex failures_mutex;
+  Result result;
+  auto worker = [&]() {
+    // Each thread uses its own copies, so stateful functors need no locking
+    Generate local_generate = generate;
+    Reference local_reference = reference;
+    Candidate local_candidate = candidate;
+    uint64_t local_cases_run = 0;
+    for (uint64_t begin = next_case.fetch_add(kBlockSize);
+         begin < options.num_cases && num_failures.load() < options.max_failures;
+         begin = next_case.fetch_add(kBlockSize)) {
+      uint64_t end = std::min(options.num_cases, begin + kBlockSize);
+      for (uint64_t case_index = begin; case_index < end; ++case_index) {
+        uint64_t case_seed = CaseSeed(options.seed, case_index);
+        Engine engine(case_seed);
+        auto input = local_generate(engine);
+        ++local_cases_run;
+        if (internal::CaseFails(input, local_reference, local_candidate)) {
+          std::lock_guard<std::mutex> lock(failures_mutex);
+          result.failures.push_back(Failure{case_index, case_seed});
+          ++num_failures;
+        }
+      }
+    }
+    num_cases_run += local_cases_run;
+  };
+  thread_pool::ParallelFor(0, num_threads, 1, [&](size_t) { worker(); });
+  result.num_cases_run = num_cases_run.load();
+
+  std::sort(result.failures.begin(), result.failures.end(),
+            [](const Failure& left, const Failure& right) {
+              return left.case_index < right.case_index;
+            });
+  if (result.failures.size() > options.max_failures) {
+    result.failures.resize(options.max_failures);
+  }
+  for (const Failure& failure : result.failures) {
+    Engine engine(failure.case_seed);
+    auto input = generate(engine);
+    size_t num_checks = 0;
+    auto shrunk = internal::Shrink(input, [&](const auto& smaller) {
+      return internal::CaseFails(smaller, reference, candidate);
+    }, options.max_shrink_checks, num_checks);
+    internal::PrintFailure(name, failure, input, shrunk, num_checks, reference, candidate,
+                           options);
+  }
+  if (options.verbose || !result.Passed()) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                   start_time).count();
+    std::cout << "[" << name << "] " << (result.Passed() ? "passed " : "failed after ")
+              << result.num_cases_run << " cases (seed " << options.seed << ", " << num_threads
+              << " threads) in " << seconds << " s" << std::endl;
+  }
+  return result;
+}
+
+}  // namespace differential_test
+
+#endif  // DIFFERENTIAL_TEST_HPP
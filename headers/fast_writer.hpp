@@ -0,0 +1,192 @@
+#ifndef FAST_WRITER_HPP
+#define FAST_WRITER_HPP
+
+#include <unistd.h> // write
+
+#include <cerrno>
+#include <charconv> // std::to_chars
+#include <cstdio> // FILE, std::fwrite
+#include <cstring> // std::memcpy
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+// Buffered output sink for large dumps: bytes are collected in one big buffer and only written
+// to the file descriptor / FILE* on Flush() (or when the buffer fills up). Numbers are formatted
+// with std::to_chars, so there is no sentry, locale or virtual call per element.
+class FastWriter {
+ public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;
+  static constexpr int kShortestFloat = -1;
+
+  // A buffer_size of 0 is taken as 1, i.e. unbuffered output
+  explicit FastWriter(int fd, size_t buffer_size = kDefaultBufferSize) :
+      fd_(fd), capacity_(buffer_size > 0 ? buffer_size : 1), buffer_(new char[capacity_]) {}
+
+  explicit FastWriter(std::FILE* file, size_t buffer_size = kDefaultBufferSize) :
+      file_(file), capacity_(buffer_size > 0 ? buffer_size : 1), buffer_(new char[capacity_]) {}
+
+  FastWriter(const FastWriter&) = delete;
+  FastWriter& operator=(const FastWriter&) = delete;
+
+  ~FastWriter() {
+    Flush();
+  }
+
+  // Floats are written like printf("%.*g") with this precision, which matches std::ostream's
+  // default of 6. Use kShortestFloat for the shortest representation that round-trips.
+  void SetFloatPrecision(int precision) {
+    float_precision_ = precision;
+  }
+
+  int FloatPrecision() const { return float_precision_; }
+
+  // False once any write to the underlying fd / FILE* has failed
+  bool Good() const { return good_; }
+
+  void Put(char ch) {
+    if (size_ == capacity_) {
+      Flush();
+    }
+    buffer_[size_++] = ch;
+  }
+
+  void Write(const char* data, size_t length) {
+    if (length > capacity_ - size_) {
+      Flush();
+      if (length > capacity_) {
+        WriteToSink(data, length);
+        return;
+      }
+    }
+    std::memcpy(buffer_.get() + size_, data, length);
+    size_ += length;
+  }
+
+  void Write(std::string_view s) {
+    Write(s.data(), s.size());
+  }
+
+  template <typename IntType>
+  void WriteInt(IntType value) {
+    static_assert(std::is_integral<IntType>::value, "Integral type required");
+    Reserve(kMaxNumberChars);
+    size_ += std::to_chars(buffer_.get() + size_, buffer_.get() + capacity_, value).ptr -
+             (buffer_.get() + size_);
+  }
+
+  template <typename FloatType>
+  void WriteFloat(FloatType value) {
+    static_assert(std::is_floating_point<FloatType>::value, "Float type required");
+    char* begin = nullptr;
+    std::to_chars_result result;
+    if (float_precision_ < 0) {
+      Reserve(kMaxNumberChars);
+      begin = buffer_.get() + size_;
+      result = std::to_chars(begin, buffer_.get() + capacity_, value);
+    } else {
+      Reserve(kMaxNumberChars + static_cast<size_t>(float_precision_));
+      begin = buffer_.get() + size_;
+      result = std::to_chars(begin, buffer_.get() + capacity_, value,
+                             std::chars_format::general, float_precision_);
+    }
+    size_ += result.ptr - begin;
+  }
+
+  // Writes the buffered bytes to the fd / FILE*
+  void Flush() {
+    if (size_ > 0) {
+      WriteToSink(buffer_.get(), size_);
+      size_ = 0;
+    }
+    if (file_ != nullptr) {
+      std::fflush(file_);
+    }
+  }
+
+  FastWriter& operator<<(std::string_view s) {
+    Write(s);
+    return *this;
+  }
+
+  FastWriter& operator<<(const char* s) {
+    Write(std::string_view(s));
+    return *this;
+  }
+
+  // chars are written as characters and bools as 0/1, same as std::ostream
+  FastWriter& operator<<(char ch) {
+    Put(ch);
+    return *this;
+  }
+
+  FastWriter& operator<<(signed char ch) {
+    Put(static_cast<char>(ch));
+    return *this;
+  }
+
+  FastWriter& operator<<(unsigned char ch) {
+    Put(static_cast<char>(ch));
+    return *this;
+  }
+
+  FastWriter& operator<<(bool value) {
+    Put(value ? '1' : '0');
+    return *this;
+  }
+
+  template <typename NumberType>
+  typename std::enable_if<std::is_arithmetic<NumberType>::value, FastWriter&>::type
+  operator<<(NumberType value) {
+    if constexpr (std::is_floating_point<NumberType>::value) {
+      WriteFloat(value);
+    } else {
+      WriteInt(value);
+    }
+    return *this;
+  }
+
+ private:
+  // Enough for any integer and for the shortest round-trip form of any double
+  static constexpr size_t kMaxNumberChars = 32;
+
+  int fd_ = -1;
+  std::FILE* file_ = nullptr;
+  size_t capacity_;  // Declared before buffer_, which is allocated from it
+  std::unique_ptr<char[]> buffer_;
+  size_t size_ = 0;
+  int float_precision_ = 6;
+  bool good_ = true;
+
+  // Makes sure at least num_chars bytes are free, growing the buffer for huge float precisions
+  void Reserve(size_t num_chars) {
+    if (num_chars > capacity_ - size_) {
+      Flush();
+      if (num_chars > capacity_) {
+        buffer_.reset(new char[num_chars]);
+        capacity_ = num_chars;
+      }
+    }
+  }
+
+  void WriteToSink(const char* data, size_t length) {
+    if (file_ != nullptr) {
+      good_ &= std::fwrite(data, 1, length, file_) == length;
+      return;
+    }
+    while (length > 0) {
+      ssize_t bytes_written = ::write(fd_, data, length);
+      if (bytes_written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        good_ = false;
+        return;
+      }
+      data += bytes_written;
+      length -= static_cast<size_t>(bytes_written);
+    }
+  }
+};
+
+#endif  // FAST_WRITER_HPP
@@ -0,0 +1,593 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <climits> // INT_MAX
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility> // std::move, std::forward
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Work-stealing thread pool. Every worker owns a Chase-Lev deque: tasks it spawns go to the
+// bottom of its own deque and it pops them from there (newest first, cache-warm), while idle
+// workers steal from the top of the others' deques (oldest first, the largest pieces of a split
+// range). Tasks from threads outside the pool go through a shared injection queue. Idle workers
+// sleep on a futex (a condition variable off Linux) and are woken when work is pushed.
+//
+//   thread_pool::ParallelFor(0, n, 1024, [&](size_t i) { output[i] = f(input[i]); });
+//
+//   thread_pool::TaskGroup group;
+//   group.Run([&]() { left_result = Solve(left); });
+//   group.Run([&]() { right_result = Solve(right); });
+//   group.Wait();
+//
+// A thread waiting on a TaskGroup runs queued tasks meanwhile, so nested parallelism does not
+// deadlock, and a pool of num_threads has num_threads - 1 workers: the waiting thread is the
+// last one. With one hardware thread, everything runs inline on the caller.
+//
+// Not everything is lock-free. The deques are, but the injection queue is a mutex around a
+// std::deque: outside threads take the newest task from it while workers take the oldest, which
+// a lock-free ring cannot offer, and it only sees top-level submissions (tasks spawned inside the
+// pool go to the deques). Also, a worker waiting on a nested group that finds nothing to run
+// yield()s in a loop rather than sleeping, since a sleeping worker could hold up the very tasks
+// it waits for.
+namespace thread_pool {
+
+struct Options {
+  size_t num_threads = 0;  // 0 means one per hardware thread, the calling thread included
+  // Pins worker i to the (first_cpu + i)-th CPU the process may run on (Linux only)
+  bool pin_threads = false;
+  size_t first_cpu = 0;
+};
+
+namespace internal {
+
+struct Task {
+  virtual ~Task() = default;
+  virtual void Run() = 0;
+};
+
+template <typename Function>
+class FunctionTask : public Task {
+ public:
+  explicit FunctionTask(Function function) : function_(std::move(function)) {}
+  void Run() override { function_(); }
+
+ private:
+  Function function_;
+};
+
+// Event count: a waiter announces itself and reads the epoch, checks once more for work, then
+// sleeps only while the epoch is unchanged. Notify bumps the epoch before looking for waiters,
+// so a notification between the check and the sleep is never lost.
+class WakeSignal {
+ public:
+  uint32_t PrepareWait() {
+    num_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  void CancelWait() {
+    num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Wait(uint32_t epoch) {
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain word");
+    while (epoch_.load(std::memory_order_acquire) == epoch) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, epoch,
+              nullptr, nullptr, 0);
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [&]() { return epoch_.load(std::memory_order_acquire) != epoch; });
+#endif
+    num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Notify(bool notify_all) {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (num_waiters_.load(std::memory_order_seq_cst) == 0) {
+      return;
+    }
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE,
+            notify_all ? INT_MAX : 1, nullptr, nullptr, 0);
+#else
+    // Taking the lock orders the epoch change before a waiter's check under the lock
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    if (notify_all) {
+      condition_.notify_all();
+    } else {
+      condition_.notify_one();
+    }
+#endif
+  }
+
+ private:
+  std::atomic<uint32_t> epoch_{0};
+  std::atomic<int> num_waiters_{0};
+#if !defined(__linux__)
+  std::mutex mutex_;
+  std::condition_variable condition_;
+#endif
+};
+
+// Chase-Lev work-stealing deque, after Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models", with seq_cst accesses in place of their fences (same cost on x86, and visible
+// to ThreadSanitizer). Only the owner calls Push and Pop, any thread calls Steal. The circular
+// array doubles when full; old arrays are kept until the deque is destroyed, since a thief may
+// still be reading one.
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque() {
+    arrays_.push_back(std::make_unique<Array>(kInitialCapacity));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  void Push(Task* task) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<int64_t>(array->capacity) - 1) {
+      array = Grow(array, top, bottom);
+    }
+    array->Store(bottom, task);
+    bottom_.store(bottom + 1, std::memory_order_release);
+  }
+
+  Task* Pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Task* task = array->Load(bottom);
+    if (top == bottom) {
+      // Last element: race the thieves for it
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // nullptr if the deque is empty or another thread took the element first
+  Task* Steal() {
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    Array* array = array_.load(std::memory_order_acquire);
+    Task* task = array->Load(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return task;
+  }
+
+  bool Empty() const {
+    return top_.load(std::memory_order_relaxed) >= bottom_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kInitialCapacity = 256;
+
+  struct Array {
+    explicit Array(size_t capacity_) :
+        capacity(capacity_), slots(new std::atomic<Task*>[capacity_]) {}
+
+    Task* Load(int64_t index) const {
+      return slots[static_cast<size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    void Store(int64_t index, Task* task) {
+      slots[static_cast<size_t>(index) & (capacity - 1)].store(task, std::memory_order_relaxed);
+    }
+
+    size_t capacity;  // a power of two
+    std::unique_ptr<std::atomic<Task*>[]> slots;
+  };
+
+  Array* Grow(Array* array, int64_t top, int64_t bottom) {
+    arrays_.push_back(std::make_unique<Array>(2 * array->capacity));
+    Array* grown = arrays_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->Store(i, array->Load(i));
+    }
+    array_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+  std::atomic<Array*> array_{nullptr};
+  std::vector<std::unique_ptr<Array>> arrays_;  // owner only
+};
+
+inline size_t NumHardwareThreads() {
+  static const size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+  return num_threads;
+}
+
+}  // namespace internal
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t num_threads = 0) : ThreadPool(Options{num_threads}) {}
+
+  explicit ThreadPool(const Options& options) {
+    size_t num_threads = options.num_threads == 0 ? internal::NumHardwareThreads() :
+                                                    options.num_threads;
+    size_t num_workers = num_threads - 1;
+    deques_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+      deques_.push_back(std::make_unique<internal::WorkStealingDeque>());
+    }
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this, i]() { WorkerLoop(i); });
+      if (options.pin_threads) {
+        PinThread(workers_.back(), options.first_cpu + i);
+      }
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Every TaskGroup using the pool must have been waited for
+  ~ThreadPool() {
+    stop_.store(true, std::memory_order_seq_cst);
+    signal_.Notify(true);
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Workers plus the waiting thread
+  size_t NumThreads() const { return workers_.size() + 1; }
+
+  bool IsWorkerThread() const { return current_pool_ == this; }
+
+  // Queues a task: on the calling worker's own deque, or on the injection queue from outside
+  void Push(internal::Task* task) {
+    if (current_pool_ == this) {
+      deques_[current_worker_]->Push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(injection_mutex_);
+      injection_queue_.push_back(task);
+      injection_size_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    signal_.Notify(false);
+  }
+
+  // Runs one queued task on the calling thread, returns false if none was found
+  bool TryRunOneTask() {
+    internal::Task* task = FindTask(current_pool_ == this ? current_worker_ : kNotAWorker);
+    if (task == nullptr) {
+      return false;
+    }
+    RunTask(task);
+    return true;
+  }
+
+ private:
+  static constexpr size_t kNotAWorker = static_cast<size_t>(-1);
+  // FindTask retries before a worker sleeps, cheaper than a futex round trip for short gaps
+  static constexpr int kSpinCount = 64;
+
+  std::vector<std::unique_ptr<internal::WorkStealingDeque>> deques_;
+  std::vector<std::thread> workers_;
+  std::mutex injection_mutex_;
+  std::deque<internal::Task*> injection_queue_;
+  std::atomic<size_t> injection_size_{0};
+  internal::WakeSignal signal_;
+  std::atomic<bool> stop_{false};
+
+  static inline thread_local ThreadPool* current_pool_ = nullptr;
+  static inline thread_local size_t current_worker_ = 0;
+  static inline thread_local uint64_t steal_seed_ = 0;
+
+  static void RunTask(internal::Task* task) {
+    task->Run();
+    delete task;
+  }
+
+  // Workers take the oldest task, like a steal. Outside threads only get here while waiting, and
+  // take the newest: depth first, like a worker popping its own deque, so nested waits do not
+  // pile up one stack frame per queued task.
+  internal::Task* PopInjected(bool newest) {
+    if (injection_size_.load(std::memory_order_seq_cst) == 0) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(injection_mutex_);
+    if (injection_queue_.empty()) {
+      return nullptr;
+    }
+    internal::Task* task;
+    if (newest) {
+      task = injection_queue_.back();
+      injection_queue_.pop_back();
+    } else {
+      task = injection_queue_.front();
+      injection_queue_.pop_front();
+    }
+    injection_size_.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  // Own deque first, then the injection queue, then the other deques from a random start
+  internal::Task* FindTask(size_t self) {
+    if (self != kNotAWorker) {
+      if (internal::Task* task = deques_[self]->Pop()) {
+        return task;
+      }
+    }
+    if (internal::Task* task = PopInjected(self == kNotAWorker)) {
+      return task;
+    }
+    size_t num_deques = deques_.size();
+    if (num_deques == 0) {
+      return nullptr;
+    }
+    // xorshift, per thread
+    steal_seed_ ^= steal_seed_ == 0 ? reinterpret_cast<uintptr_t>(&steal_seed_) | 1 : 0;
+    steal_seed_ ^= steal_seed_ << 13;
+    steal_seed_ ^= steal_seed_ >> 7;
+    steal_seed_ ^= steal_seed_ << 17;
+    size_t start = static_cast<size_t>(steal_seed_ % num_deques);
+    for (size_t i = 0; i < num_deques; ++i) {
+      size_t victim = (start + i) % num_deques;
+      if (victim == self) {
+        continue;
+      }
+      // A failed steal may only mean another thief won the race, so retry while non-empty
+      while (!deques_[victim]->Empty()) {
+        if (internal::Task* task = deques_[victim]->Steal()) {
+          return task;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  void WorkerLoop(size_t index) {
+    current_pool_ = this;
+    current_worker_ = index;
+    while (true) {
+      internal::Task* task = FindTask(index);
+      for (int spin = 0; task == nullptr && spin < kSpinCount; ++spin) {
+        std::this_thread::yield();
+        task = FindTask(index);
+      }
+      if (task == nullptr) {
+        uint32_t epoch = signal_.PrepareWait();
+        task = FindTask(index);
+        if (task == nullptr) {
+          if (stop_.load(std::memory_order_seq_cst)) {
+            signal_.CancelWait();
+            return;
+          }
+          signal_.Wait(epoch);
+          continue;
+        }
+        signal_.CancelWait();
+      }
+      RunTask(task);
+    }
+  }
+
+  static void PinThread(std::thread& thread, size_t cpu_rank) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+      return;
+    }
+    size_t rank = cpu_rank % static_cast<size_t>(CPU_COUNT(&allowed));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed) && rank-- == 0) {
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(pinned), &pinned);
+        return;
+      }
+    }
+#else
+    (void)thread;
+    (void)cpu_rank;
+#endif
+  }
+};
+
+// Pool shared by the parallel utilities, one thread per hardware thread, created on first use
+inline ThreadPool& DefaultThreadPool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+// Tasks that can be waited for together. Exceptions thrown by tasks are caught; Wait rethrows
+// the first one after all tasks have finished.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool = DefaultThreadPool()) : pool_(pool) {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  // Tasks refer to the group, so it cannot go away before they finish
+  ~TaskGroup() {
+    WaitForTasks();
+  }
+
+  // If copying function, allocating the task or queueing it throws, the group is left as it was
+  template <typename Function>
+  void Run(Function&& function) {
+    auto task = [this, function = std::forward<Function>(function)]() mutable {
+      try {
+        function();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex_);
+        if (!exception_) {
+          exception_ = std::current_exception();
+        }
+      }
+      Finish();
+    };
+    auto owned_task = std::make_unique<internal::FunctionTask<decltype(task)>>(std::move(task));
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    try {
+      pool_.Push(owned_task.get());
+    } catch (...) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+    // Queued: the pool deletes it after running it
+    owned_task.release();
+  }
+
+  // Runs queued tasks (of any group) until all of this group's tasks have finished
+  void Wait() {
+    WaitForTasks();
+    std::exception_ptr exception;
+    {
+      std::lock_guard<std::mutex> lock(exception_mutex_);
+      std::swap(exception, exception_);
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+ private:
+  ThreadPool& pool_;
+  std::atomic<size_t> pending_{0};
+  // Finish calls still running: the group must outlive them even after pending_ reaches 0
+  std::atomic<size_t> num_finishing_{0};
+  internal::WakeSignal done_signal_;
+  std::mutex exception_mutex_;
+  std::exception_ptr exception_;
+
+  void Finish() {
+    num_finishing_.fetch_add(1, std::memory_order_seq_cst);
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      done_signal_.Notify(true);
+    }
+    num_finishing_.fetch_sub(1, std::memory_order_release);
+  }
+
+  void WaitForTasks() {
+    // Only threads outside the pool may sleep: workers keep running tasks, so the tasks a
+    // sleeping thread waits for always make progress. Without workers nobody else runs them.
+    bool may_sleep = !pool_.IsWorkerThread() && pool_.NumThreads() > 1;
+    while (pending_.load(std::memory_order_acquire) != 0) {
+      if (pool_.TryRunOneTask()) {
+        continue;
+      }
+      if (!may_sleep) {
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t epoch = done_signal_.PrepareWait();
+      if (pending_.load(std::memory_order_acquire) == 0) {
+        done_signal_.CancelWait();
+        break;
+      }
+      done_signal_.Wait(epoch);
+    }
+    while (num_finishing_.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+namespace internal {
+
+// Lazy binary splitting: the upper half of the range becomes a task, the lower half is split
+// again, so a thief always takes the largest remaining piece
+template <typename Function>
+void SplitAndRun(TaskGroup& group, size_t begin, size_t end, size_t grain,
+                 const Function& function) {
+  while (end - begin > grain) {
+    size_t middle = begin + (end - begin) / 2;
+    group.Run([&group, middle, end, grain, &function]() {
+      SplitAndRun(group, middle, end, grain, function);
+    });
+    end = middle;
+  }
+  for (size_t i = begin; i < end; ++i) {
+    function(i);
+  }
+}
+
+}  // namespace internal
+
+// Calls function(i) for every i in [begin, end), in pieces of at least grain indices spread
+// over the pool. Returns once all calls have finished; rethrows the first exception.
+template <typename Function>
+void ParallelFor(size_t begin, size_t end, size_t grain, Function function,
+                 ThreadPool& pool = DefaultThreadPool()) {
+  grain = std::max<size_t>(1, grain);
+  if (begin >= end) {
+    return;
+  }
+  if (end - begin <= grain || pool.NumThreads() == 1) {
+    for (size_t i = begin; i < end; ++i) {
+      function(i);
+    }
+    return;
+  }
+  TaskGroup group(pool);
+  internal::SplitAndRun(group, begin, end, grain, function);
+  group.Wait();
+}
+
+// Reduces [begin, end) split into pieces of grain indices: map_range(piece_begin, piece_end)
+// computes each piece's value in parallel, then combine(accumulated, value) folds them left to
+// right, starting from identity. The pieces and the order do not depend on the thread count,
+// so neither does the result, even for floating point sums.
+template <typename T, typename MapRange, typename Combine>
+T ParallelReduce(size_t begin, size_t end, size_t grain, T identity, MapRange map_range,
+                 Combine combine, ThreadPool& pool = DefaultThreadPool()) {
+  grain = std::max<size_t>(1, grain);
+  if (begin >= end) {
+    return identity;
+  }
+  size_t num_pieces = (end - begin + grain - 1) / grain;
+  std::vector<T> values(num_pieces, identity);
+  ParallelFor(0, num_pieces, 1, [&](size_t piece_i) {
+    size_t piece_begin = begin + piece_i * grain;
+    values[piece_i] = map_range(piece_begin, std::min(end, piece_begin + grain));
+  }, pool);
+  T result = std::move(identity);
+  for (T& value : values) {
+    result = combine(std::move(result), std::move(value));
+  }
+  return result;
+}
+
+}  // namespace thread_pool
+
+#endif  // THREAD_POOL_HPP
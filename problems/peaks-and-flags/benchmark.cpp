@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "peak_range_index.hpp"
+#include "peaks_and_flags.hpp"
+#include "streaming_peaks_and_flags.hpp"
+#include "timer.hpp"
+
+// Compares the flag searches on the many-peak inputs used for time_stats.txt (uniform values in
+// [0, 2]). The index is built once per size, the search times are averaged over repeats.
+template <typename Search>
+double AverageSeconds(Timer& timer, int num_repeats, int& result, Search search) {
+  timer.Reset();
+  for (int repeat = 0; repeat < num_repeats; ++repeat) {
+    result = search();
+  }
+  return timer.GetSeconds() / num_repeats;
+}
+
+int main() {
+  Timer timer;
+  std::default_random_engine engine(2024);
+  std::uniform_int_distribution<int> distribution(0, 2);
+  std::cout << "size : exhaustive binary parallel (seconds per search) : build end-to-end"
+            << std::endl;
+  for (size_t size = 1000; size <= 10000000; size *= 10) {
+    std::vector<int> test_vector(size);
+    for (int& value : test_vector) {
+      value = distribution(engine);
+    }
+    timer.Reset();
+    NextPeakIndex next_peaks(test_vector);
+    double build_runtime = timer.GetSeconds();
+
+    int num_repeats = static_cast<int>(std::max<size_t>(1, 1000000 / size));
+    int max_candidate = std::ceil(std::sqrt(static_cast<double>(size)));
+    int exhaustive_result = 0;
+    int binary_result = 0;
+    int parallel_result = 0;
+    double exhaustive_runtime = AverageSeconds(timer, num_repeats, exhaustive_result, [&]() {
+      return ExhaustiveSearchNumFlags(0, max_candidate, next_peaks);
+    });
+    double binary_runtime = AverageSeconds(timer, num_repeats, binary_result, [&]() {
+      return MaxFlags(next_peaks);
+    });
+    double parallel_runtime = AverageSeconds(timer, num_repeats, parallel_result, [&]() {
+      return MaxFlagsParallel(next_peaks);
+    });
+    int end_to_end_result = 0;
+    double end_to_end_runtime = AverageSeconds(timer, 1, end_to_end_result, [&]() {
+      return MaxFlags(test_vector);
+    });
+
+    std::cout << size << " : " << exhaustive_runtime << " " << binary_runtime << " "
+              << parallel_runtime << " : " << build_runtime << " " << end_to_end_runtime;
+    if (exhaustive_result != binary_result || binary_result != parallel_result ||
+        binary_result != end_to_end_result) {
+      std::cout << " (results differ!)";
+    }
+    std::cout << std::endl;
+  }
+
+  // Streaming: 10^7 samples appended in chunks, querying after every 64th chunk, against
+  // copying the window and calling MaxFlags for the same queries
+  constexpr size_t kStreamSize = 10000000;
+  constexpr size_t kChunkSize = 4096;
+  std::vector<int> stream(kStreamSize);
+  for (int& value : stream) {
+    value = distribution(engine);
+  }
+  for (size_t window_size : {size_t{0}, size_t{1} << 20}) {
+    StreamingPeaksAndFlags streaming(window_size);
+    int num_queries = 0;
+    int dummy_accumulator = 0;
+    timer.Reset();
+    for (size_t begin = 0; begin < kStreamSize; begin += kChunkSize) {
+      streaming.Append(stream.data() + begin, std::min(kChunkSize, kStreamSize - begin));
+      if ((begin / kChunkSize) % 64 == 63) {
+        dummy_accumulator += streaming.MaxFlags();
+        ++num_queries;
+      }
+    }
+    double streaming_runtime = timer.GetSeconds();
+
+    timer.Reset();
+    for (size_t end = 64 * kChunkSize; end <= kStreamSize; end += 64 * kChunkSize) {
+      size_t begin = (window_size == 0 || end <= window_size) ? 0 : end - window_size;
+      dummy_accumulator -= MaxFlags(std::vector<int>(stream.begin() + begin, stream.begin() + end));
+    }
+    double rebuild_runtime = timer.GetSeconds();
+    std::cout << "Streaming (window " << window_size << "): " << kStreamSize << " samples, "
+              << num_queries << " queries in " << streaming_runtime << " s, rebuilding "
+              << rebuild_runtime << " s" << (dummy_accumulator != 0 ? " (results differ!)" : "")
+              << std::endl;
+  }
+
+  // Range queries: 10^4 random windows of the 10^7 signal, copying each window versus one index
+  PeakRangeIndex range_index(stream);
+  std::uniform_int_distribution<size_t> length_distribution(1, 100000);
+  std::vector<std::pair<size_t, size_t>> ranges(10000);
+  for (std::pair<size_t, size_t>& range : ranges) {
+    size_t length = length_distribution(engine);
+    range.first = std::uniform_int_distribution<size_t>(0, kStreamSize - length)(engine);
+    range.second = range.first + length - 1;
+  }
+  timer.Reset();
+  std::vector<int> copy_results;
+  for (const std::pair<size_t, size_t>& range : ranges) {
+    copy_results.push_back(MaxFlags(std::vector<int>(stream.begin() + range.first,
+                                                     stream.begin() + range.second + 1)));
+  }
+  double copy_runtime = timer.GetSeconds();
+  timer.Reset();
+  std::vector<int> index_results;
+  for (const std::pair<size_t, size_t>& range : ranges) {
+    index_results.push_back(range_index.MaxFlags(range.first, range.second));
+  }
+  double index_runtime = timer.GetSeconds();
+  timer.Reset();
+  std::vector<int> batch_results = range_index.MaxFlags(ranges);
+  double batch_runtime = timer.GetSeconds();
+  std::cout << "Range queries (" << ranges.size() << "): copying " << copy_runtime << " s, index "
+            << index_runtime << " s, batch " << batch_runtime << " s"
+            << (copy_results != index_results || index_results != batch_results ?
+                " (results differ!)" : "") << std::endl;
+  return 0;
+}
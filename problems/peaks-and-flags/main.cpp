@@ -6,6 +6,7 @@
 #include <map>
 #include <vector>
 
+#include "peaks_and_flags.hpp"
 #include "timer.hpp"
 
 template <typename T>
@@ -21,64 +22,6 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
   return os;
 }
 
-std::vector<size_t> ComputePeakIndices(const std::vector<int>& input_vector) {
-  std::vector<size_t> peak_indices;
-  for (size_t i = 0; i < input_vector.size(); ++i) {
-    bool greater_than_prev = (i == 0) || (input_vector[i] > input_vector[i - 1]);
-    bool greater_than_next = (i + 1 == input_vector.size()) || (input_vector[i] > input_vector[i + 1]);
-    if (greater_than_prev && greater_than_next) {
-      peak_indices.push_back(i);
-    }
-  }
-  return peak_indices;
-}
-
-std::vector<size_t> ComputeNextPeakIndices(const std::vector<int>& input_vector) {
-  std::vector<size_t> peak_indices = ComputePeakIndices(input_vector);
-  std::vector<size_t> next_peak_indices;
-  for (size_t peak_i : peak_indices) {
-    next_peak_indices.insert(next_peak_indices.end(), peak_i - next_peak_indices.size() + 1, peak_i);
-  }
-  return next_peak_indices;
-}
-
-// O(sqrt(original vector length))
-bool CheckFlagsPossible(int num_flags, const std::vector<size_t>& next_peak_indices) {
-  if (num_flags == 0) {
-    return true;
-  }
-  if (next_peak_indices.empty()) {
-    return false;
-  }
-  size_t current_index = next_peak_indices[0];
-  int flags_placed = 1;
-  while (flags_placed < num_flags)  {
-    current_index += num_flags; // must have at least num_flags distance between flags
-    if (current_index + 1 > next_peak_indices.size()) {
-      return false;
-    }
-    current_index = next_peak_indices[current_index];
-    ++flags_placed;
-  }
-  return true;
-}
-
-int BinarySearchNumFlags(int min_flags, int max_flags, const std::vector<size_t>& next_peak_indices) {
-  if (max_flags > min_flags) {
-    int lower_max_flags = min_flags + (max_flags - min_flags)/2;
-    return std::max(BinarySearchNumFlags(min_flags, lower_max_flags, next_peak_indices),
-                    BinarySearchNumFlags(lower_max_flags + 1, max_flags, next_peak_indices));
-  }
-  return CheckFlagsPossible(min_flags, next_peak_indices) ? min_flags : -1;
-}
-
-// O(log n * sqrt(n)) + O(n) = O(n)
-int MaxFlags(const std::vector<int>& input_vector) {
-  std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(input_vector);
-  int max_flags = std::ceil(std::sqrt(static_cast<int>(input_vector.size())));
-  return BinarySearchNumFlags(0, max_flags, next_peak_indices);
-}
-
 int CurrentTimeNano() {
   auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch();
   return std::chrono::duration_cast<std::chrono::nanoseconds>(current_time).count();
@@ -92,7 +35,7 @@ int main() {
   const size_t kMinSize = 1000;
   const size_t kMaxSize = 10000000;
   size_t size = kMinSize;
-  int dummy_accumulator;
+  int dummy_accumulator = 0;
   while (size <= kMaxSize) {
     std::vector<int> test_vector(size);
     for (size_t i = 0; i < test_vector.size(); ++i) {
@@ -113,6 +56,37 @@ int main() {
   }
   
   std::cout << (dummy_accumulator & 1 ? " " : "") << std::endl; 
+
+  // Peak detection alone on the largest input
+  std::vector<int> peak_vector(kMaxSize);
+  for (int& value : peak_vector) {
+    value = distribution(engine);
+  }
+  timer.Reset();
+  size_t num_scalar_peaks = ComputePeakIndices(peak_vector).size();
+  double scalar_runtime = timer.GetSeconds();
+  timer.Reset();
+  size_t num_avx2_peaks = ComputePeakIndicesAvx2(peak_vector).size();
+  double avx2_runtime = timer.GetSeconds();
+  timer.Reset();
+  size_t num_parallel_peaks = ComputePeakIndicesParallel(peak_vector).size();
+  double parallel_runtime = timer.GetSeconds();
+  std::cout << "ComputePeakIndices (" << kMaxSize << " elements): scalar " << scalar_runtime
+            << " s, AVX2 " << avx2_runtime << " s, parallel " << parallel_runtime << " s"
+            << (num_scalar_peaks == num_avx2_peaks && num_avx2_peaks == num_parallel_peaks ?
+                "" : " (peak counts differ!)") << std::endl;
+
+  // Next-peak representations for the same input
+  timer.Reset();
+  std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(peak_vector);
+  double vector_runtime = timer.GetSeconds();
+  timer.Reset();
+  NextPeakIndex next_peaks(peak_vector);
+  double index_runtime = timer.GetSeconds();
+  std::cout << "Next peak vector: " << next_peak_indices.size() * sizeof(size_t) << " bytes, "
+            << vector_runtime << " s to build" << std::endl;
+  std::cout << "NextPeakIndex:    " << next_peaks.MemoryBytes() << " bytes, " << index_runtime
+            << " s to build" << std::endl;
   
   return 0;
 }
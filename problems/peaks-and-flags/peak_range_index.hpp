@@ -0,0 +1,107 @@
+#ifndef PEAK_RANGE_INDEX_HPP
+#define PEAK_RANGE_INDEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "peaks_and_flags.hpp"
+
+// Answers MaxFlags over many sub-ranges of one signal without copying them. Built once in O(n),
+// it keeps the sorted positions of the interior peaks (greater than both neighbours) of the
+// whole array and a NextPeakIndex over it. Inside a range [l, r] the interior peaks are exactly
+// the range's peaks strictly between l and r: binary searching the list bounds and counts them,
+// and the greedy placement steps through them in O(1) with the NextPeakIndex. Only l and r,
+// which lose a neighbour, are re-checked against the signal. The signal must outlive the index.
+// Queries only read the index, so any number of threads may call them at once.
+class PeakRangeIndex {
+ public:
+  explicit PeakRangeIndex(const std::vector<int>& input_vector, size_t num_threads = 0) :
+      data_(input_vector.data()), size_(input_vector.size()),
+      interior_peaks_(ComputePeakIndicesParallel(input_vector, num_threads)),
+      next_peaks_(input_vector, num_threads) {
+    // The ends of the whole array are peaks of the array, but not interior ones
+    if (!interior_peaks_.empty() && interior_peaks_.back() + 1 == size_) {
+      interior_peaks_.pop_back();
+    }
+    if (!interior_peaks_.empty() && interior_peaks_.front() == 0) {
+      interior_peaks_.erase(interior_peaks_.begin());
+    }
+  }
+
+  size_t Size() const { return size_; }
+  const std::vector<size_t>& InteriorPeaks() const { return interior_peaks_; }
+
+  // Same result as MaxFlags on a copy of elements [l, r] (inclusive) of the signal.
+  // O(log n) to count the range's peaks, then O(log(r - l)) checks of O(sqrt(r - l)) steps each.
+  int MaxFlags(size_t l, size_t r) const {
+    if (l > r || r >= size_) {
+      throw std::out_of_range("PeakRangeIndex::MaxFlags: invalid range");
+    }
+    bool l_is_peak = l == r || data_[l] > data_[l + 1];
+    bool r_is_peak = l != r && data_[r] > data_[r - 1];
+    auto interior_begin = std::upper_bound(interior_peaks_.begin(), interior_peaks_.end(), l);
+    auto interior_end = std::lower_bound(interior_begin, interior_peaks_.end(), r);
+    size_t num_interior_peaks = interior_end - interior_begin;
+    size_t num_peaks = num_interior_peaks + l_is_peak + r_is_peak;
+    if (num_peaks == 0) {
+      return 0;
+    }
+    size_t first_peak = l_is_peak ? l : (num_interior_peaks ? *interior_begin : r);
+    size_t last_peak = r_is_peak ? r : (num_interior_peaks ? interior_end[-1] : l);
+    int max_flags = peaks_internal::MaxFlagsUpperBound(num_peaks, last_peak - first_peak);
+    return peaks_internal::BinarySearchMaxFlags(max_flags, [&](int num_flags) {
+      return CheckFlagsPossible(num_flags, first_peak, r, r_is_peak);
+    });
+  }
+
+  // Answers ranges[i] = {l, r} into the returned vector, spreading the queries over num_threads
+  // threads (0 means one per pool thread). Query costs vary with the range length, so the
+  // threads take small blocks of queries from a shared counter instead of fixed slices.
+  std::vector<int> MaxFlags(const std::vector<std::pair<size_t, size_t>>& ranges,
+                            size_t num_threads = 0) const {
+    constexpr size_t kBlockSize = 16;
+    std::vector<int> results(ranges.size());
+    std::atomic<size_t> next_query(0);
+    size_t num_workers = peaks_internal::NumChunks(ranges.size(), kBlockSize, num_threads);
+    peaks_internal::ForEachChunkParallel(num_workers, [&](size_t) {
+      for (size_t begin = next_query.fetch_add(kBlockSize); begin < ranges.size();
+           begin = next_query.fetch_add(kBlockSize)) {
+        size_t end = std::min(ranges.size(), begin + kBlockSize);
+        for (size_t i = begin; i < end; ++i) {
+          results[i] = MaxFlags(ranges[i].first, ranges[i].second);
+        }
+      }
+    });
+    return results;
+  }
+
+ private:
+  const int* data_;
+  size_t size_;
+  std::vector<size_t> interior_peaks_;
+  NextPeakIndex next_peaks_;
+
+  // Greedy placement from first_peak within a range ending at r. Peaks of the whole array before
+  // r are interior peaks of the range (the search never goes back to position 0), r itself is
+  // only usable when it is a peak of the range.
+  bool CheckFlagsPossible(int num_flags, size_t first_peak, size_t r, bool r_is_peak) const {
+    size_t current_index = first_peak;
+    for (int flags_placed = 1; flags_placed < num_flags; ++flags_placed) {
+      size_t target = current_index + num_flags;
+      size_t next_index = target < r ? next_peaks_.NextPeakAtOrAfter(target) : r;
+      if (next_index < r) {
+        current_index = next_index;
+      } else if (r_is_peak && r >= target) {
+        current_index = r;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+#endif  // PEAK_RANGE_INDEX_HPP
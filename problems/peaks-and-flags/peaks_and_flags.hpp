@@ -0,0 +1,513 @@
+#ifndef PEAKS_AND_FLAGS_HPP
+#define PEAKS_AND_FLAGS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "../../headers/thread_pool.hpp"
+
+// Reference implementation, the faster variants below must match it exactly
+inline std::vector<size_t> ComputePeakIndices(const std::vector<int>& input_vector) {
+  std::vector<size_t> peak_indices;
+  for (size_t i = 0; i < input_vector.size(); ++i) {
+    bool greater_than_prev = (i == 0) || (input_vector[i] > input_vector[i - 1]);
+    bool greater_than_next = (i + 1 == input_vector.size()) || (input_vector[i] > input_vector[i + 1]);
+    if (greater_than_prev && greater_than_next) {
+      peak_indices.push_back(i);
+    }
+  }
+  return peak_indices;
+}
+
+namespace peaks_internal {
+
+// Peaks never touch, so [begin, end) holds at most this many
+inline size_t MaxPeaksInRange(size_t begin, size_t end) {
+  return (end - begin + 1) / 2;
+}
+
+// Appends the peaks of data[0, size) that lie in [begin, end). The neighbours data[begin - 1] and
+// data[end] are read when they exist, so a chunk of a larger array sees its halo elements.
+inline void AppendPeakIndicesScalar(const int* data, size_t size, size_t begin, size_t end,
+                                    std::vector<size_t>& peak_indices) {
+  for (size_t i = begin; i < end; ++i) {
+    bool greater_than_prev = (i == 0) || (data[i] > data[i - 1]);
+    bool greater_than_next = (i + 1 == size) || (data[i] > data[i + 1]);
+    if (greater_than_prev && greater_than_next) {
+      peak_indices.push_back(i);
+    }
+  }
+}
+
+// Peak bitmask of elements [64 * word_i, 64 * word_i + 64) of data[0, size), bit j is set when
+// element 64 * word_i + j is a peak
+inline uint64_t PeakWordScalar(const int* data, size_t size, size_t word_i) {
+  size_t begin = 64 * word_i;
+  size_t end = std::min(size, begin + 64);
+  uint64_t word = 0;
+  for (size_t i = begin; i < end; ++i) {
+    bool greater_than_prev = (i == 0) || (data[i] > data[i - 1]);
+    bool greater_than_next = (i + 1 == size) || (data[i] > data[i + 1]);
+    word |= static_cast<uint64_t>(greater_than_prev && greater_than_next) << (i - begin);
+  }
+  return word;
+}
+
+#if defined(__x86_64__)
+
+// Byte k of entry mask is the position of the k-th set bit of mask
+constexpr std::array<uint64_t, 256> MakeCompressTable() {
+  std::array<uint64_t, 256> table{};
+  for (unsigned mask = 0; mask < 256; ++mask) {
+    int num_set = 0;
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      if (mask & (1u << bit)) {
+        table[mask] |= static_cast<uint64_t>(bit) << (8 * num_set++);
+      }
+    }
+  }
+  return table;
+}
+
+constexpr std::array<uint64_t, 256> kCompressTable = MakeCompressTable();
+
+// Compares 8 elements against the loads shifted by one either way, then writes the indices
+// selected by the resulting bitmask with a table lookup instead of a branch per element. All 8
+// slots are stored every step and the output pointer advances by the number of peaks.
+__attribute__((target("avx2")))
+inline void AppendPeakIndicesAvx2(const int* data, size_t size, size_t begin, size_t end,
+                                  std::vector<size_t>& peak_indices) {
+  // Elements 0 and size - 1 have a missing neighbour, they go through the scalar loop
+  size_t simd_begin = std::min(std::max<size_t>(begin, 1), end);
+  size_t simd_end = std::max(simd_begin, std::min(end, size - 1));
+  AppendPeakIndicesScalar(data, size, begin, simd_begin, peak_indices);
+
+  size_t old_size = peak_indices.size();
+  peak_indices.resize(old_size + MaxPeaksInRange(simd_begin, simd_end) + 8);
+  size_t* out = peak_indices.data() + old_size;
+  size_t i = simd_begin;
+  for (; i + 8 <= simd_end; i += 8) {
+    __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 1));
+    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+    __m256i is_peak = _mm256_and_si256(_mm256_cmpgt_epi32(current, prev),
+                                       _mm256_cmpgt_epi32(current, next));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(is_peak)));
+    __m128i positions = _mm_cvtsi64_si128(static_cast<long long>(kCompressTable[mask]));
+    __m256i base = _mm256_set1_epi64x(static_cast<long long>(i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_add_epi64(base, _mm256_cvtepu8_epi64(positions)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4),
+                        _mm256_add_epi64(base, _mm256_cvtepu8_epi64(_mm_srli_si128(positions, 4))));
+    out += __builtin_popcount(mask);
+  }
+  peak_indices.resize(out - peak_indices.data());
+
+  AppendPeakIndicesScalar(data, size, i, end, peak_indices);
+}
+
+// Fills peak_words[word_begin, word_end) with PeakWordScalar, 8 elements per compare
+__attribute__((target("avx2")))
+inline void FillPeakWordsAvx2(const int* data, size_t size, size_t word_begin, size_t word_end,
+                              uint64_t* peak_words) {
+  for (size_t word_i = word_begin; word_i < word_end; ++word_i) {
+    size_t begin = 64 * word_i;
+    if (begin == 0 || begin + 64 >= size) {
+      peak_words[word_i] = PeakWordScalar(data, size, word_i);
+      continue;
+    }
+    uint64_t word = 0;
+    for (size_t j = 0; j < 64; j += 8) {
+      const int* block = data + begin + j;
+      __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+      __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block - 1));
+      __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 1));
+      __m256i is_peak = _mm256_and_si256(_mm256_cmpgt_epi32(current, prev),
+                                         _mm256_cmpgt_epi32(current, next));
+      word |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(is_peak))) << j;
+    }
+    peak_words[word_i] = word;
+  }
+}
+
+inline bool HasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#endif
+
+inline void AppendPeakIndices(const int* data, size_t size, size_t begin, size_t end,
+                              std::vector<size_t>& peak_indices) {
+#if defined(__x86_64__)
+  if (HasAvx2()) {
+    AppendPeakIndicesAvx2(data, size, begin, end, peak_indices);
+    return;
+  }
+#endif
+  AppendPeakIndicesScalar(data, size, begin, end, peak_indices);
+}
+
+inline void FillPeakWords(const int* data, size_t size, size_t word_begin, size_t word_end,
+                          uint64_t* peak_words) {
+#if defined(__x86_64__)
+  if (HasAvx2()) {
+    FillPeakWordsAvx2(data, size, word_begin, word_end, peak_words);
+    return;
+  }
+#endif
+  for (size_t word_i = word_begin; word_i < word_end; ++word_i) {
+    peak_words[word_i] = PeakWordScalar(data, size, word_i);
+  }
+}
+
+// Number of chunks to split num_items into: num_threads (0 means one per pool thread), but
+// no chunk smaller than min_chunk_size
+inline size_t NumChunks(size_t num_items, size_t min_chunk_size, size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  return std::max<size_t>(1, std::min(num_threads, num_items / min_chunk_size));
+}
+
+// Calls fn(chunk_i) for every chunk_i in [0, num_chunks), one pool task per chunk
+template <typename ChunkFunction>
+void ForEachChunkParallel(size_t num_chunks, ChunkFunction fn) {
+  thread_pool::ParallelFor(0, num_chunks, 1, fn);
+}
+
+}  // namespace peaks_internal
+
+// Same result as ComputePeakIndices, using the AVX2 kernel when the CPU has it
+inline std::vector<size_t> ComputePeakIndicesAvx2(const std::vector<int>& input_vector) {
+  std::vector<size_t> peak_indices;
+  peaks_internal::AppendPeakIndices(input_vector.data(), input_vector.size(), 0,
+                                    input_vector.size(), peak_indices);
+  return peak_indices;
+}
+
+// Splits the input into num_threads chunks (0 means one per pool thread). Each chunk reads
+// one halo element on either side to classify its boundary elements, so every index is decided
+// by exactly one thread, and the per-chunk results are concatenated in order.
+inline std::vector<size_t> ComputePeakIndicesParallel(const std::vector<int>& input_vector,
+                                                      size_t num_threads = 0) {
+  // Below this a chunk is not worth a thread
+  constexpr size_t kMinChunkSize = 1 << 16;
+  size_t num_chunks = peaks_internal::NumChunks(input_vector.size(), kMinChunkSize, num_threads);
+  if (num_chunks == 1) {
+    return ComputePeakIndicesAvx2(input_vector);
+  }
+
+  const int* data = input_vector.data();
+  size_t size = input_vector.size();
+  std::vector<std::vector<size_t>> chunk_peak_indices(num_chunks);
+  peaks_internal::ForEachChunkParallel(num_chunks, [&](size_t chunk_i) {
+    size_t begin = size * chunk_i / num_chunks;
+    size_t end = size * (chunk_i + 1) / num_chunks;
+    peaks_internal::AppendPeakIndices(data, size, begin, end, chunk_peak_indices[chunk_i]);
+  });
+
+  size_t num_peaks = 0;
+  for (const std::vector<size_t>& chunk : chunk_peak_indices) {
+    num_peaks += chunk.size();
+  }
+  std::vector<size_t> peak_indices;
+  peak_indices.reserve(num_peaks);
+  for (const std::vector<size_t>& chunk : chunk_peak_indices) {
+    peak_indices.insert(peak_indices.end(), chunk.begin(), chunk.end());
+  }
+  return peak_indices;
+}
+
+inline std::vector<size_t> ComputeNextPeakIndices(const std::vector<int>& input_vector) {
+  std::vector<size_t> peak_indices = ComputePeakIndicesParallel(input_vector);
+  std::vector<size_t> next_peak_indices;
+  for (size_t peak_i : peak_indices) {
+    next_peak_indices.insert(next_peak_indices.end(), peak_i - next_peak_indices.size() + 1, peak_i);
+  }
+  return next_peak_indices;
+}
+
+// Answers "first peak at or after i" in O(1) from one bit per element plus the first peak of
+// every 64-element block: about 0.25 bytes per element instead of the 8 of the vector built by
+// ComputeNextPeakIndices. The input is never copied and no list of peak indices is materialized.
+class NextPeakIndex {
+ public:
+  static constexpr size_t kNoPeak = static_cast<size_t>(-1);
+
+  explicit NextPeakIndex(const std::vector<int>& input_vector, size_t num_threads = 0) :
+      size_(input_vector.size()), peak_words_((input_vector.size() + 63) / 64),
+      block_first_peak_(peak_words_.size() + 1, kNoPeak) {
+    // Below this many words a chunk is not worth a thread
+    constexpr size_t kMinChunkWords = 1 << 10;
+    const int* data = input_vector.data();
+    size_t num_words = peak_words_.size();
+    size_t num_chunks = peaks_internal::NumChunks(num_words, kMinChunkWords, num_threads);
+    peaks_internal::ForEachChunkParallel(num_chunks, [&](size_t chunk_i) {
+      peaks_internal::FillPeakWords(data, size_, num_words * chunk_i / num_chunks,
+                                    num_words * (chunk_i + 1) / num_chunks, peak_words_.data());
+    });
+    for (size_t word_i = num_words; word_i-- > 0;) {
+      uint64_t word = peak_words_[word_i];
+      num_peaks_ += __builtin_popcountll(word);
+      block_first_peak_[word_i] = word ? 64 * word_i + __builtin_ctzll(word) :
+                                         block_first_peak_[word_i + 1];
+      if (word && last_peak_ == kNoPeak) {
+        last_peak_ = 64 * word_i + 63 - __builtin_clzll(word);
+      }
+    }
+  }
+
+  size_t Size() const { return size_; }
+  size_t NumPeaks() const { return num_peaks_; }
+
+  // kNoPeak when there are no peaks
+  size_t FirstPeak() const { return block_first_peak_[0]; }
+  size_t LastPeak() const { return last_peak_; }
+
+  bool IsPeak(size_t i) const { return (peak_words_[i / 64] >> (i % 64)) & 1; }
+
+  // Smallest peak index >= i, or kNoPeak
+  size_t NextPeakAtOrAfter(size_t i) const {
+    if (i >= size_) {
+      return kNoPeak;
+    }
+    uint64_t word = peak_words_[i / 64] >> (i % 64);
+    return word ? i + __builtin_ctzll(word) : block_first_peak_[i / 64 + 1];
+  }
+
+  size_t MemoryBytes() const {
+    return peak_words_.size() * sizeof(uint64_t) + block_first_peak_.size() * sizeof(size_t);
+  }
+
+ private:
+  size_t size_;
+  size_t num_peaks_ = 0;
+  size_t last_peak_ = kNoPeak;
+  std::vector<uint64_t> peak_words_;
+  // First peak at or after element 64 * block, with a kNoPeak sentinel past the last block
+  std::vector<size_t> block_first_peak_;
+};
+
+namespace peaks_internal {
+
+// Greedy flag placement on next_peaks, polling keep_going() every 64 flags. Returns std::nullopt
+// if it was told to stop before reaching an answer.
+template <typename KeepGoing>
+std::optional<bool> PlaceFlags(int num_flags, const NextPeakIndex& next_peaks,
+                               KeepGoing keep_going) {
+  if (num_flags == 0) {
+    return true;
+  }
+  size_t current_index = next_peaks.FirstPeak();
+  for (int flags_placed = 1; flags_placed < num_flags; ++flags_placed) {
+    if (current_index == NextPeakIndex::kNoPeak) {
+      return false;
+    }
+    if (flags_placed % 64 == 0 && !keep_going()) {
+      return std::nullopt;
+    }
+    // must have at least num_flags distance between flags
+    current_index = next_peaks.NextPeakAtOrAfter(current_index + num_flags);
+  }
+  return current_index != NextPeakIndex::kNoPeak;
+}
+
+}  // namespace peaks_internal
+
+// O(sqrt(original vector length))
+inline bool CheckFlagsPossible(int num_flags, const NextPeakIndex& next_peaks) {
+  return *peaks_internal::PlaceFlags(num_flags, next_peaks, []() { return true; });
+}
+
+// O(sqrt(original vector length))
+inline bool CheckFlagsPossible(int num_flags, const std::vector<size_t>& next_peak_indices) {
+  if (num_flags == 0) {
+    return true;
+  }
+  if (next_peak_indices.empty()) {
+    return false;
+  }
+  size_t current_index = next_peak_indices[0];
+  int flags_placed = 1;
+  while (flags_placed < num_flags)  {
+    current_index += num_flags; // must have at least num_flags distance between flags
+    if (current_index + 1 > next_peak_indices.size()) {
+      return false;
+    }
+    current_index = next_peak_indices[current_index];
+    ++flags_placed;
+  }
+  return true;
+}
+
+// Checks every candidate in [min_flags, max_flags] and keeps the largest feasible one, O(sqrt(n))
+// checks. Kept as the reference for test.cpp and benchmark.cpp. NextPeaks is a NextPeakIndex or
+// the vector from ComputeNextPeakIndices.
+template <typename NextPeaks>
+int ExhaustiveSearchNumFlags(int min_flags, int max_flags, const NextPeaks& next_peak_indices) {
+  if (max_flags > min_flags) {
+    int lower_max_flags = min_flags + (max_flags - min_flags)/2;
+    return std::max(ExhaustiveSearchNumFlags(min_flags, lower_max_flags, next_peak_indices),
+                    ExhaustiveSearchNumFlags(lower_max_flags + 1, max_flags, next_peak_indices));
+  }
+  return CheckFlagsPossible(min_flags, next_peak_indices) ? min_flags : -1;
+}
+
+namespace peaks_internal {
+
+// Feasibility is monotone: dropping the last of k placed flags leaves k - 1 flags that are at least
+// k > k - 1 apart. k flags also need k distinct peaks and k - 1 gaps of at least k between the
+// first and last peak, so the answer is at most the largest k with k <= num_peaks and
+// k * (k - 1) <= span = last_peak - first_peak.
+inline int MaxFlagsUpperBound(size_t num_peaks, size_t span) {
+  if (num_peaks == 0) {
+    return 0;
+  }
+  size_t k = static_cast<size_t>((1 + std::sqrt(1 + 4.0 * static_cast<double>(span))) / 2);
+  while (k * (k - 1) > span) {
+    --k;
+  }
+  while ((k + 1) * k <= span) {
+    ++k;
+  }
+  return static_cast<int>(std::min(k, num_peaks));
+}
+
+// Largest num_flags in [0, max_flags] with check(num_flags), for a monotone check
+template <typename Check>
+int BinarySearchMaxFlags(int max_flags, Check check) {
+  int min_flags = 0;  // always feasible
+  while (min_flags < max_flags) {
+    int mid_flags = min_flags + (max_flags - min_flags + 1) / 2;
+    if (check(mid_flags)) {
+      min_flags = mid_flags;
+    } else {
+      max_flags = mid_flags - 1;
+    }
+  }
+  return min_flags;
+}
+
+// std::lower_bound for targets expected near first: doubles the step until it passes value, then
+// binary searches the last step, O(log distance) and touching only nearby memory
+template <typename Iterator, typename T>
+Iterator GallopLowerBound(Iterator first, Iterator last, const T& value) {
+  size_t step = 1;
+  size_t size = last - first;
+  while (step < size && first[step - 1] < value) {
+    step *= 2;
+  }
+  return std::lower_bound(first + step / 2, first + std::min(step, size), value);
+}
+
+}  // namespace peaks_internal
+
+inline int MaxFlagsUpperBound(const NextPeakIndex& next_peaks) {
+  if (next_peaks.NumPeaks() == 0) {
+    return 0;
+  }
+  return peaks_internal::MaxFlagsUpperBound(next_peaks.NumPeaks(),
+                                            next_peaks.LastPeak() - next_peaks.FirstPeak());
+}
+
+// Binary search over [0, MaxFlagsUpperBound], O(log sqrt(n)) feasibility checks
+inline int MaxFlags(const NextPeakIndex& next_peaks) {
+  return peaks_internal::BinarySearchMaxFlags(MaxFlagsUpperBound(next_peaks), [&](int num_flags) {
+    return CheckFlagsPossible(num_flags, next_peaks);
+  });
+}
+
+// Greedy placement over a sorted list of peak positions (any random access container), jumping
+// to the next usable peak with a galloping search. O(num_flags * log(num_peaks)).
+template <typename SortedPeaks>
+bool CheckFlagsPossibleSorted(int num_flags, const SortedPeaks& peaks) {
+  if (num_flags == 0) {
+    return true;
+  }
+  auto current = peaks.begin();
+  for (int flags_placed = 1; flags_placed < num_flags; ++flags_placed) {
+    if (current == peaks.end()) {
+      return false;
+    }
+    current = peaks_internal::GallopLowerBound(current + 1, peaks.end(), *current + num_flags);
+  }
+  return current != peaks.end();
+}
+
+// Max flags for a signal given only its sorted peak positions, used by the streaming and range
+// query engines which keep peaks but not a per-element index
+template <typename SortedPeaks>
+int MaxFlagsFromSortedPeaks(const SortedPeaks& peaks) {
+  if (peaks.begin() == peaks.end()) {
+    return 0;
+  }
+  size_t num_peaks = peaks.end() - peaks.begin();
+  size_t span = *(peaks.end() - 1) - *peaks.begin();
+  int max_flags = peaks_internal::MaxFlagsUpperBound(num_peaks, span);
+  return peaks_internal::BinarySearchMaxFlags(max_flags, [&](int num_flags) {
+    return CheckFlagsPossibleSorted(num_flags, peaks);
+  });
+}
+
+// k-ary search: each round checks up to num_threads candidates spread over the remaining range
+// concurrently (0 means one per pool thread). A check stops early once another thread proves
+// a larger candidate feasible or a smaller one infeasible, since monotonicity decides it then.
+inline int MaxFlagsParallel(const NextPeakIndex& next_peaks, size_t num_threads = 0) {
+  if (num_threads == 0) {
+    num_threads = thread_pool::DefaultThreadPool().NumThreads();
+  }
+  int min_flags = 0;
+  int max_flags = MaxFlagsUpperBound(next_peaks);
+  std::vector<int> candidates;
+  while (min_flags < max_flags) {
+    size_t num_candidates = std::min<size_t>(num_threads, max_flags - min_flags);
+    candidates.clear();
+    for (size_t i = 1; i <= num_candidates; ++i) {
+      int64_t range = max_flags - min_flags;
+      candidates.push_back(min_flags + static_cast<int>((range * i + num_candidates) /
+                                                        (num_candidates + 1)));
+    }
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::atomic<int> max_feasible(min_flags);
+    std::atomic<int> min_infeasible(max_flags + 1);
+    peaks_internal::ForEachChunkParallel(candidates.size(), [&](size_t candidate_i) {
+      int num_flags = candidates[candidate_i];
+      std::optional<bool> possible = peaks_internal::PlaceFlags(num_flags, next_peaks, [&]() {
+        return max_feasible.load(std::memory_order_relaxed) < num_flags &&
+               min_infeasible.load(std::memory_order_relaxed) > num_flags;
+      });
+      if (possible == true) {
+        int current = max_feasible.load();
+        while (current < num_flags && !max_feasible.compare_exchange_weak(current, num_flags)) {}
+      } else if (possible == false) {
+        int current = min_infeasible.load();
+        while (current > num_flags && !min_infeasible.compare_exchange_weak(current, num_flags)) {}
+      }
+    });
+    min_flags = max_feasible.load();
+    max_flags = min_infeasible.load() - 1;
+  }
+  return min_flags;
+}
+
+// O(n) to build the index, then O(sqrt(n) log n) for the search
+inline int MaxFlags(const std::vector<int>& input_vector) {
+  return MaxFlags(NextPeakIndex(input_vector));
+}
+
+inline int MaxFlagsParallel(const std::vector<int>& input_vector, size_t num_threads = 0) {
+  return MaxFlagsParallel(NextPeakIndex(input_vector, num_threads), num_threads);
+}
+
+#endif  // PEAKS_AND_FLAGS_HPP
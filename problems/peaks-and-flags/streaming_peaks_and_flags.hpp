@@ -0,0 +1,105 @@
+#ifndef STREAMING_PEAKS_AND_FLAGS_HPP
+#define STREAMING_PEAKS_AND_FLAGS_HPP
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "peaks_and_flags.hpp"
+
+// Incremental peaks and flags over an append-only signal. Appending a chunk updates the peak set
+// in O(chunk), and MaxFlags() answers for the whole stream (window_size == 0) or for its last
+// window_size samples, with the same result as MaxFlags() on a copy of that vector. Only the
+// peak positions are kept, plus the samples of the window in sliding mode, so memory stays
+// O(window_size) there.
+class StreamingPeaksAndFlags {
+ public:
+  explicit StreamingPeaksAndFlags(size_t window_size = 0) :
+      window_size_(window_size), samples_(window_size == 0 ? 2 : window_size + 1) {}
+
+  // Peaks strictly inside the chunk go through the same (AVX2) kernel as ComputePeakIndices, only
+  // the two chunk ends look at neighbouring samples
+  void Append(const int* samples, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    size_t base = num_samples_;
+    size_t new_end = base + count;
+    size_t new_begin = (window_size_ == 0 || new_end <= window_size_) ? 0 : new_end - window_size_;
+    // The previous last element is a peak only if it also beats the first new sample
+    if (base > 0 && !peaks_.empty() && peaks_.back() == base - 1 &&
+        !(Sample(base - 1) > samples[0])) {
+      peaks_.pop_back();
+    }
+    if ((base == 0 || samples[0] > Sample(base - 1)) && (count == 1 || samples[0] > samples[1])) {
+      peaks_.push_back(base);
+    }
+    if (count >= 3) {
+      // Peaks that would leave the window straight away are skipped
+      size_t num_evicted = new_begin > base ? new_begin - base : 0;
+      size_t interior_begin = std::min(std::max<size_t>(1, num_evicted), count - 1);
+      chunk_peaks_.clear();
+      peaks_internal::AppendPeakIndices(samples, count, interior_begin, count - 1, chunk_peaks_);
+      for (size_t peak : chunk_peaks_) {
+        peaks_.push_back(base + peak);
+      }
+    }
+    // The new last element is provisionally a peak if it beats its predecessor
+    if (count >= 2 && samples[count - 1] > samples[count - 2]) {
+      peaks_.push_back(new_end - 1);
+    }
+    for (size_t i = count - std::min(count, samples_.size()); i < count; ++i) {
+      samples_[(base + i) % samples_.size()] = samples[i];
+    }
+    num_samples_ = new_end;
+    if (new_begin > window_begin_) {
+      MoveWindowBegin(new_begin);
+    }
+  }
+
+  void Append(int sample) {
+    Append(&sample, 1);
+  }
+
+  void Append(const std::vector<int>& samples) {
+    Append(samples.data(), samples.size());
+  }
+
+  // Max flags over the current window (the whole stream in unbounded mode)
+  int MaxFlags() const {
+    return MaxFlagsFromSortedPeaks(peaks_);
+  }
+
+  // Total samples appended so far, and the number currently in the window
+  size_t NumSamples() const { return num_samples_; }
+  size_t WindowSize() const { return num_samples_ - window_begin_; }
+
+  // Positions (as stream indices) of the peaks in the current window, ascending
+  const std::deque<size_t>& Peaks() const { return peaks_; }
+
+ private:
+  size_t window_size_;
+  size_t num_samples_ = 0;
+  size_t window_begin_ = 0;
+  // Ring buffer of the last window_size + 1 samples (the last 2 in unbounded mode)
+  std::vector<int> samples_;
+  std::deque<size_t> peaks_;
+  std::vector<size_t> chunk_peaks_;  // scratch for the kernel output
+
+  int Sample(size_t index) const { return samples_[index % samples_.size()]; }
+
+  // Drops the samples before new_begin. The new first element has no left neighbour any more, so
+  // it becomes a peak as soon as it beats its right neighbour (or has none).
+  void MoveWindowBegin(size_t new_begin) {
+    while (!peaks_.empty() && peaks_.front() < new_begin) {
+      peaks_.pop_front();
+    }
+    window_begin_ = new_begin;
+    bool is_peak = new_begin + 1 == num_samples_ || Sample(new_begin) > Sample(new_begin + 1);
+    if (is_peak && (peaks_.empty() || peaks_.front() != new_begin)) {
+      peaks_.push_front(new_begin);
+    }
+  }
+};
+
+#endif  // STREAMING_PEAKS_AND_FLAGS_HPP
@@ -1,8 +1,14 @@
 #include <cmath>
 #include <algorithm>
+#include <climits>
 #include <iostream>
+#include <random>
 #include <vector>
 
+#include "../../headers/differential_test.hpp"
+#include "peak_range_index.hpp"
+#include "peaks_and_flags.hpp"
+#include "streaming_peaks_and_flags.hpp"
 #include "timer.hpp"
 
 template <typename T>
@@ -18,87 +24,280 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
   return os;
 }
 
-std::vector<size_t> ComputePeakIndices(const std::vector<int>& input_vector) {
-  std::vector<size_t> peak_indices;
-  for (size_t i = 0; i < input_vector.size(); ++i) {
-    bool greater_than_prev = (i == 0) || (input_vector[i] > input_vector[i - 1]);
-    bool greater_than_next = (i + 1 == input_vector.size()) || (input_vector[i] > input_vector[i + 1]);
-    if (greater_than_prev && greater_than_next) {
-      peak_indices.push_back(i);
-    }
-  }
-  return peak_indices;
+void DebugTest(const std::vector<int>& input_vector) {
+  std::cout << "Input vector: " << input_vector << std::endl;
+  std::cout << "Peak indices: " << ComputePeakIndices(input_vector) << std::endl;
+  std::cout << "Next peak is: " << ComputeNextPeakIndices(input_vector) << std::endl;
+  std::cout << std::endl;
 }
 
-std::vector<size_t> ComputeNextPeakIndices(const std::vector<int>& input_vector) {
-  std::vector<size_t> peak_indices = ComputePeakIndices(input_vector);
-  std::vector<size_t> next_peak_indices;
-  for (size_t peak_i : peak_indices) {
-    next_peak_indices.insert(next_peak_indices.end(), peak_i - next_peak_indices.size() + 1, peak_i);
+void TestFlagsPossible(const std::vector<int>& input_vector) {
+  std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(input_vector);
+  bool possible = true;
+  for (int num_flags = 0; possible; ++num_flags) {
+    possible = CheckFlagsPossible(num_flags, next_peak_indices);
+    std::cout << "Possible with " << num_flags << "? " << possible << std::endl;
   }
-  return next_peak_indices;
+  std::cout << std::endl;
 }
 
-// O(sqrt(original vector length))
-bool CheckFlagsPossible(int num_flags, const std::vector<size_t>& next_peak_indices) {
-  if (num_flags == 0) {
-    return true;
-  }
-  if (next_peak_indices.empty()) {
-    return false;
+void TestMaxFlags(const std::vector<int>& input_vector) {
+  std::cout << "Max flags: " << MaxFlags(input_vector) << std::endl;
+  std::cout << std::endl;
+}
+
+// The AVX2 and chunked variants must reproduce the scalar peak indices exactly, including at
+// chunk boundaries, on plateaus and at the int extremes
+int TestPeakIndicesMatch() {
+  std::mt19937 engine(12345);
+  std::vector<int> value_ranges{1, 2, 3, INT_MAX};
+  std::vector<size_t> sizes;
+  for (size_t size = 0; size <= 70; ++size) {
+    sizes.push_back(size);
   }
-  size_t current_index = next_peak_indices[0];
-  int flags_placed = 1;
-  while (flags_placed < num_flags)  {
-    current_index += num_flags; // must have at least num_flags distance between flags
-    if (current_index + 1 > next_peak_indices.size()) {
-      return false;
+  sizes.insert(sizes.end(), {1000, 65536, 65537, 300001, 1000003});
+  int num_cases = 0;
+  int num_mismatches = 0;
+  for (size_t size : sizes) {
+    for (int value_range : value_ranges) {
+      std::uniform_int_distribution<int> distribution(-value_range, value_range);
+      std::vector<int> input_vector(size);
+      for (int& value : input_vector) {
+        value = distribution(engine);
+        if (value_range == INT_MAX && engine() % 8 == 0) {
+          value = (engine() & 1) ? INT_MAX : INT_MIN;
+        }
+      }
+      std::vector<size_t> expected = ComputePeakIndices(input_vector);
+      num_mismatches += ComputePeakIndicesAvx2(input_vector) != expected;
+      for (size_t num_threads : {1, 2, 3, 8, 15}) {
+        num_mismatches += ComputePeakIndicesParallel(input_vector, num_threads) != expected;
+      }
+      ++num_cases;
     }
-    current_index = next_peak_indices[current_index];
-    ++flags_placed;
   }
-  return true;
+  std::cout << "Peak index variants: " << num_cases << " inputs, " << num_mismatches
+            << " mismatches" << std::endl;
+  std::cout << std::endl;
+  return num_mismatches;
 }
 
-int BinarySearchNumFlags(int min_flags, int max_flags, const std::vector<size_t>& next_peak_indices) {
-  if (max_flags > min_flags) {
-    int lower_max_flags = min_flags + (max_flags - min_flags)/2;
-    return std::max(BinarySearchNumFlags(min_flags, lower_max_flags, next_peak_indices),
-                    BinarySearchNumFlags(lower_max_flags + 1, max_flags, next_peak_indices));
+// NextPeakIndex must answer every query like the vector from ComputeNextPeakIndices, and
+// CheckFlagsPossible must agree on both representations
+int TestNextPeakIndexMatch() {
+  std::mt19937 engine(678);
+  int num_cases = 0;
+  int num_mismatches = 0;
+  for (size_t size : {0, 1, 2, 63, 64, 65, 127, 128, 129, 1000, 200000}) {
+    for (int value_range : {1, 2, 100}) {
+      std::uniform_int_distribution<int> distribution(0, value_range);
+      std::vector<int> input_vector(size);
+      for (int& value : input_vector) {
+        value = distribution(engine);
+      }
+      std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(input_vector);
+      std::vector<size_t> peak_indices = ComputePeakIndices(input_vector);
+      for (size_t num_threads : {1, 4}) {
+        NextPeakIndex next_peaks(input_vector, num_threads);
+        bool match = next_peaks.NumPeaks() == peak_indices.size() &&
+                     next_peaks.FirstPeak() == (peak_indices.empty() ? NextPeakIndex::kNoPeak :
+                                                                       peak_indices.front()) &&
+                     next_peaks.LastPeak() == (peak_indices.empty() ? NextPeakIndex::kNoPeak :
+                                                                      peak_indices.back());
+        for (size_t i = 0; i <= size + 1; ++i) {
+          size_t expected = i < next_peak_indices.size() ? next_peak_indices[i] :
+                                                           NextPeakIndex::kNoPeak;
+          match = match && next_peaks.NextPeakAtOrAfter(i) == expected;
+        }
+        for (int num_flags = 0; num_flags * num_flags <= static_cast<int>(size) + 4; ++num_flags) {
+          match = match && CheckFlagsPossible(num_flags, next_peaks) ==
+                               CheckFlagsPossible(num_flags, next_peak_indices);
+        }
+        num_mismatches += !match;
+        ++num_cases;
+      }
+    }
   }
-  return CheckFlagsPossible(min_flags, next_peak_indices) ? min_flags : -1;
+  std::cout << "NextPeakIndex: " << num_cases << " inputs, " << num_mismatches << " mismatches"
+            << std::endl;
+  std::cout << std::endl;
+  return num_mismatches;
 }
 
-// O(log n * sqrt(n)) + O(n) = O(n)
-int MaxFlags(const std::vector<int>& input_vector) {
-  std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(input_vector);
-  int max_flags = std::ceil(std::sqrt(static_cast<int>(input_vector.size())));
-  return BinarySearchNumFlags(0, max_flags, next_peak_indices);
+// The binary and parallel k-ary searches must find the same answer as checking every candidate
+int TestMaxFlagsSearches() {
+  std::mt19937 engine(91011);
+  int num_cases = 0;
+  int num_mismatches = 0;
+  for (size_t size : {0, 1, 2, 3, 5, 8, 13, 50, 100, 1000, 10000, 250000}) {
+    for (int value_range : {1, 2, 1000}) {
+      std::uniform_int_distribution<int> distribution(0, value_range);
+      std::vector<int> input_vector(size);
+      for (int& value : input_vector) {
+        value = distribution(engine);
+      }
+      NextPeakIndex next_peaks(input_vector);
+      int max_candidate = std::ceil(std::sqrt(static_cast<double>(size))) + 1;
+      int expected = ExhaustiveSearchNumFlags(0, max_candidate, next_peaks);
+      bool match = MaxFlags(next_peaks) == expected && MaxFlags(input_vector) == expected &&
+                   MaxFlagsUpperBound(next_peaks) >= expected;
+      for (size_t num_threads : {1, 2, 3, 8}) {
+        match = match && MaxFlagsParallel(next_peaks, num_threads) == expected;
+      }
+      num_mismatches += !match;
+      ++num_cases;
+    }
+  }
+  std::cout << "MaxFlags searches: " << num_cases << " inputs, " << num_mismatches
+            << " mismatches" << std::endl;
+  std::cout << std::endl;
+  return num_mismatches;
 }
 
-void DebugTest(const std::vector<int>& input_vector) {
-  std::cout << "Input vector: " << input_vector << std::endl;
-  std::cout << "Peak indices: " << ComputePeakIndices(input_vector) << std::endl;
-  std::cout << "Next peak is: " << ComputeNextPeakIndices(input_vector) << std::endl;
+// After every appended chunk the streaming engine must match MaxFlags and ComputePeakIndices on
+// a copy of the window
+int TestStreamingMatch() {
+  std::mt19937 engine(1213);
+  int num_checks = 0;
+  int num_mismatches = 0;
+  for (size_t window_size : {0, 1, 2, 3, 7, 64, 500}) {
+    for (int value_range : {1, 2, 1000}) {
+      std::uniform_int_distribution<int> distribution(0, value_range);
+      std::uniform_int_distribution<size_t> chunk_size_distribution(0, 40);
+      StreamingPeaksAndFlags streaming(window_size);
+      std::vector<int> history;
+      while (history.size() < 3000) {
+        std::vector<int> chunk(chunk_size_distribution(engine));
+        for (int& value : chunk) {
+          value = distribution(engine);
+        }
+        streaming.Append(chunk);
+        history.insert(history.end(), chunk.begin(), chunk.end());
+        size_t window_begin = (window_size == 0 || history.size() <= window_size) ?
+                              0 : history.size() - window_size;
+        std::vector<int> window(history.begin() + window_begin, history.end());
+        std::vector<size_t> expected_peaks = ComputePeakIndices(window);
+        for (size_t& peak : expected_peaks) {
+          peak += window_begin;
+        }
+        bool match = streaming.MaxFlags() == MaxFlags(window) &&
+                     streaming.WindowSize() == window.size() &&
+                     std::equal(expected_peaks.begin(), expected_peaks.end(),
+                                streaming.Peaks().begin(), streaming.Peaks().end());
+        num_mismatches += !match;
+        ++num_checks;
+      }
+    }
+  }
+  std::cout << "Streaming: " << num_checks << " checks, " << num_mismatches << " mismatches"
+            << std::endl;
   std::cout << std::endl;
+  return num_mismatches;
 }
 
-void TestFlagsPossible(const std::vector<int>& input_vector) {
-  std::vector<size_t> next_peak_indices = ComputeNextPeakIndices(input_vector);
-  bool possible = true;
-  for (int num_flags = 0; possible; ++num_flags) {
-    possible = CheckFlagsPossible(num_flags, next_peak_indices);
-    std::cout << "Possible with " << num_flags << "? " << possible << std::endl;
+// Range queries must match MaxFlags on a copy of the range, one at a time and in parallel batches
+int TestPeakRangeIndexMatch() {
+  std::mt19937 engine(1415);
+  int num_queries = 0;
+  int num_mismatches = 0;
+  for (size_t size : {1, 2, 3, 10, 100, 5000}) {
+    for (int value_range : {1, 2, 1000}) {
+      std::uniform_int_distribution<int> distribution(0, value_range);
+      std::vector<int> input_vector(size);
+      for (int& value : input_vector) {
+        value = distribution(engine);
+      }
+      PeakRangeIndex index(input_vector);
+      std::uniform_int_distribution<size_t> position_distribution(0, size - 1);
+      std::vector<std::pair<size_t, size_t>> ranges;
+      std::vector<int> expected;
+      for (int query = 0; query < 300; ++query) {
+        size_t l = position_distribution(engine);
+        size_t r = position_distribution(engine);
+        ranges.emplace_back(std::min(l, r), std::max(l, r));
+        std::vector<int> range_copy(input_vector.begin() + ranges.back().first,
+                                    input_vector.begin() + ranges.back().second + 1);
+        expected.push_back(MaxFlags(range_copy));
+        num_mismatches += index.MaxFlags(ranges.back().first, ranges.back().second) !=
+                          expected.back();
+        ++num_queries;
+      }
+      for (size_t num_threads : {1, 3, 8}) {
+        num_mismatches += index.MaxFlags(ranges, num_threads) != expected;
+      }
+    }
   }
+  std::cout << "PeakRangeIndex: " << num_queries << " queries, " << num_mismatches
+            << " mismatches" << std::endl;
   std::cout << std::endl;
+  return num_mismatches;
 }
 
-void TestMaxFlags(const std::vector<int>& input_vector) {
-  std::cout << "Max flags: " << MaxFlags(input_vector) << std::endl;
+// O(n * sqrt(n)) reference: tries every flag count from the most possible down (k flags need
+// (k - 1) * k <= n), placing flags greedily on the list of peaks
+int NaiveMaxFlags(const std::vector<int>& input_vector) {
+  std::vector<size_t> peak_indices = ComputePeakIndices(input_vector);
+  size_t max_flags = std::min<size_t>(peak_indices.size(), std::sqrt(input_vector.size()) + 1);
+  for (size_t num_flags = max_flags; num_flags > 0; --num_flags) {
+    size_t flags_placed = 1;
+    size_t last_flag = peak_indices[0];
+    for (size_t peak_i : peak_indices) {
+      if (peak_i >= last_flag + num_flags) {
+        last_flag = peak_i;
+        ++flags_placed;
+      }
+    }
+    if (flags_placed >= num_flags) {
+      return static_cast<int>(num_flags);
+    }
+  }
+  return 0;
+}
+
+// Mostly short signals with few distinct values (many plateaus), some long ones
+std::vector<int> GenerateSignal(differential_test::Engine& engine) {
+  size_t max_size = (engine() % 16 == 0) ? 5000 : 64;
+  std::vector<int> input_vector(engine() % (max_size + 1));
+  int max_value = 1 + static_cast<int>(engine() % 4) * static_cast<int>(engine() % 50);
+  for (int& value : input_vector) {
+    value = static_cast<int>(engine() % (max_value + 1));
+  }
+  return input_vector;
+}
+
+// Returns the number of differential runs that found a failing case
+int TestDifferential() {
+  differential_test::Options options;
+  options.num_cases = 20000;
+  std::vector<differential_test::Result> results;
+  results.push_back(differential_test::Run("MaxFlags vs naive", GenerateSignal, NaiveMaxFlags,
+                                           [](const std::vector<int>& input_vector) {
+                                             return MaxFlags(input_vector);
+                                           }, options));
+  results.push_back(differential_test::Run("MaxFlagsParallel vs naive", GenerateSignal,
+                                           NaiveMaxFlags,
+                                           [](const std::vector<int>& input_vector) {
+                                             return MaxFlagsParallel(input_vector, 3);
+                                           }, options));
+  results.push_back(differential_test::Run("ComputePeakIndicesAvx2", GenerateSignal,
+                                           ComputePeakIndices, ComputePeakIndicesAvx2, options));
   std::cout << std::endl;
+  int num_failed = 0;
+  for (const differential_test::Result& result : results) {
+    num_failed += !result.Passed();
+  }
+  return num_failed;
 }
 
 int main() {
+  int num_failures = 0;
+  num_failures += TestDifferential();
+  num_failures += TestPeakIndicesMatch();
+  num_failures += TestNextPeakIndexMatch();
+  num_failures += TestMaxFlagsSearches();
+  num_failures += TestStreamingMatch();
+  num_failures += TestPeakRangeIndexMatch();
+
   std::vector<int> input_vector{0, 2, 3, 2, 4};
   DebugTest(input_vector);
   TestFlagsPossible(input_vector);
@@ -118,6 +317,7 @@ int main() {
   DebugTest(empty_vector);
   TestFlagsPossible(empty_vector);
   TestMaxFlags(empty_vector);
-  
-  return 0;
+
+  std::cout << (num_failures == 0 ? "All tests passed" : "Tests FAILED") << std::endl;
+  return num_failures == 0 ? 0 : 1;
 }